@@ -20,8 +20,8 @@ EEPROG_TARGETS	:= eeprog
 # Programs
 #
 
-$(EEPROG_DIR)/eeprog: $(EEPROG_DIR)/eeprog.o $(EEPROG_DIR)/24cXX.o
-	$(CC) $(LDFLAGS) -o $@ $^ $(EEPROG_LDFLAGS)
+$(EEPROG_DIR)/eeprog: $(EEPROG_DIR)/eeprog.o $(EEPROG_DIR)/24cXX.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROG_LDFLAGS)
 
 #
 # Objects
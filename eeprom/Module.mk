@@ -1,4 +1,4 @@
-# EEPROM decoding scripts for the Linux eeprom driver
+# EEPROM decoding scripts and programs for the Linux eeprom driver
 #
 # Copyright (C) 2007-2013  Jean Delvare <jdelvare@suse.de>
 #
@@ -9,13 +9,61 @@
 
 EEPROM_DIR	:= eeprom
 
-EEPROM_TARGETS	:= decode-dimms decode-vaio ddcmon decode-edid
-EEPROM_MANPAGES	:= decode-dimms.1 decode-vaio.1
+EEPROM_CFLAGS	:= -Iinclude
+EEPROM_LDFLAGS	:= -lm
+ifeq ($(USE_STATIC_LIB),1)
+EEPROM_I2C_LDFLAGS := $(LIB_DIR)/$(LIB_STLIBNAME)
+else
+EEPROM_I2C_LDFLAGS := -L$(LIB_DIR) -li2c
+endif
+
+EEPROM_SCRIPTS	:= decode-dimms decode-vaio ddcmon decode-edid
+EEPROM_PROGRAMS	:= decode-spd read-spd ddcread
+EEPROM_TARGETS	:= $(EEPROM_SCRIPTS) $(EEPROM_PROGRAMS)
+EEPROM_MANPAGES	:= decode-dimms.1 decode-vaio.1 decode-spd.1 read-spd.1 ddcread.1
+
+#
+# Programs
+#
+
+$(EEPROM_DIR)/decode-spd: $(EEPROM_DIR)/decode-spd.o $(EEPROM_DIR)/spd.o
+	$(CC) $(LDFLAGS) -o $@ $^ $(EEPROM_LDFLAGS)
+
+# read-spd and ddcread share the bus helpers of the i2c tools
+$(EEPROM_DIR)/read-spd: $(EEPROM_DIR)/read-spd.o $(EEPROM_DIR)/spd.o tools/i2cbusses.o tools/util.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROM_I2C_LDFLAGS) -lpthread
+
+$(EEPROM_DIR)/ddcread: $(EEPROM_DIR)/ddcread.o tools/i2cbusses.o tools/util.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROM_I2C_LDFLAGS) -lpthread
+
+#
+# Objects
+#
+
+$(EEPROM_DIR)/decode-spd.o: $(EEPROM_DIR)/decode-spd.c $(EEPROM_DIR)/spd.h version.h
+	$(CC) $(CFLAGS) $(EEPROM_CFLAGS) -c $< -o $@
+
+$(EEPROM_DIR)/read-spd.o: $(EEPROM_DIR)/read-spd.c $(EEPROM_DIR)/spd.h tools/i2cbusses.h tools/util.h version.h $(INCLUDE_DIR)/i2c/smbus.h $(INCLUDE_DIR)/i2c/busses.h $(INCLUDE_DIR)/i2c/xfer.h
+	$(CC) $(CFLAGS) $(EEPROM_CFLAGS) -c $< -o $@
+
+$(EEPROM_DIR)/ddcread.o: $(EEPROM_DIR)/ddcread.c tools/i2cbusses.h tools/util.h version.h $(INCLUDE_DIR)/i2c/busses.h
+	$(CC) $(CFLAGS) $(EEPROM_CFLAGS) -c $< -o $@
+
+$(EEPROM_DIR)/spd.o: $(EEPROM_DIR)/spd.c $(EEPROM_DIR)/spd.h $(EEPROM_DIR)/spd-vendors.h
+	$(CC) $(CFLAGS) $(EEPROM_CFLAGS) -c $< -o $@
 
 #
 # Commands
 #
 
+all-eeprom: $(addprefix $(EEPROM_DIR)/,$(EEPROM_PROGRAMS))
+
+strip-eeprom: $(addprefix $(EEPROM_DIR)/,$(EEPROM_PROGRAMS))
+	strip $(addprefix $(EEPROM_DIR)/,$(EEPROM_PROGRAMS))
+
+clean-eeprom:
+	$(RM) $(addprefix $(EEPROM_DIR)/,*.o $(EEPROM_PROGRAMS))
+
 install-eeprom: $(addprefix $(EEPROM_DIR)/,$(EEPROM_TARGETS))
 	$(INSTALL_DIR) $(DESTDIR)$(bindir) $(DESTDIR)$(mandir)/man1
 	for program in $(EEPROM_TARGETS) ; do \
@@ -29,6 +77,12 @@ uninstall-eeprom:
 	for manual in $(EEPROM_MANPAGES) ; do \
 	$(RM) $(DESTDIR)$(mandir)/$$manual ; done
 
+all: all-eeprom
+
+strip: strip-eeprom
+
+clean: clean-eeprom
+
 install: install-eeprom
 
 uninstall: uninstall-eeprom
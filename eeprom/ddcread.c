@@ -0,0 +1,865 @@
+/*
+    ddcread - read and decode monitor EDID data over DDC
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    Based on ddcmon:
+    Copyright (C) 2004-2008  Jean Delvare <jdelvare@suse.de>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+/*
+ * A compiled counterpart of ddcmon. Instead of going through the eeprom
+ * driver, the EDID is read directly from the DDC bus with one I2C_RDWR
+ * transfer per 128-byte block, extension blocks included, and all the
+ * buses are read concurrently. The decoded data is printed with the
+ * wording of ddcmon, or as JSON.
+ */
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/busses.h>
+#include "../tools/i2cbusses.h"
+#include "../tools/util.h"
+#include "../version.h"
+
+#define DDC_ADDR	0x50	/* EDID EEPROM */
+#define DDC_SEGMENT	0x30	/* E-DDC segment pointer */
+#define EDID_BLOCK	128
+#define EDID_MAX_BLOCKS	256	/* base block + 255 extensions */
+
+#define MAX_TIMINGS	64
+
+struct timing {
+	unsigned int width, height, refresh;
+	int interlaced;
+};
+
+struct edid_limits {
+	int valid;
+	unsigned int vsync_min, vsync_max;
+	unsigned int hsync_min, hsync_max;
+	unsigned int clock_max;		/* in 10 MHz units, 0xff if unset */
+};
+
+struct edid {
+	const char *source;		/* bus name or file name */
+	int error;			/* negative errno, or -ENOMSG if not EDID */
+	unsigned char *bytes;		/* blocks * EDID_BLOCK bytes */
+	int blocks;
+
+	/* Filled by decode_edid() */
+	int has_monitor;
+	char monitor[64], serial[64], ascii[64];
+	struct edid_limits limits;
+	struct timing timings[MAX_TIMINGS];
+	int ntimings;
+	unsigned int scale0[2];		/* aspect ratio of standard timing 0 */
+};
+
+struct worker {
+	pthread_t thread;
+	int i2cbus;
+	int started;
+	char name[20];
+	struct edid edid;
+};
+
+static const unsigned int standard_scales[4][2] = {
+	{ 1, 1 }, { 3, 4 }, { 4, 5 }, { 16, 9 },
+};
+
+static const struct timing established[24] = {
+	{ 720, 400, 70, 0 },
+	{ 720, 400, 88, 0 },
+	{ 640, 480, 60, 0 },
+	{ 640, 480, 67, 0 },
+	{ 640, 480, 72, 0 },
+	{ 640, 480, 75, 0 },
+	{ 800, 600, 56, 0 },
+	{ 800, 600, 60, 0 },
+	{ 800, 600, 72, 0 },
+	{ 800, 600, 75, 0 },
+	{ 832, 624, 75, 0 },
+	{ 1024, 768, 87, 1 },
+	{ 1024, 768, 60, 0 },
+	{ 1024, 768, 70, 0 },
+	{ 1024, 768, 75, 0 },
+	{ 1280, 1024, 75, 0 },
+	{ 0 }, { 0 }, { 0 },		/* unused */
+	{ 1152, 870, 75, 0 },
+};
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: ddcread [-j] [-y] [I2CBUS...]\n"
+		"       ddcread [-j] -r FILE...\n"
+		"  I2CBUS is an integer or an I2C bus name\n"
+		"  -j  Print JSON output\n"
+		"  -r  Decode binary EDID images instead of reading buses\n"
+		"  -y  Disable interactive mode\n"
+		"  By default, all I2C adapters are read, in parallel.\n");
+}
+
+/*
+ * Acquisition
+ */
+
+/*
+ * Read one 128-byte block. Blocks past the first two live in further
+ * 256-byte segments, selected by writing the E-DDC segment pointer in
+ * the same transfer.
+ */
+static int read_block(int file, int block, unsigned char *buf)
+{
+	struct i2c_msg msgs[3], *msg = msgs;
+	struct i2c_rdwr_ioctl_data rdwr;
+	__u8 segment = block / 2;
+	__u8 offset = (block % 2) * EDID_BLOCK;
+
+	if (segment) {
+		msg->addr = DDC_SEGMENT;
+		msg->flags = 0;
+		msg->len = 1;
+		msg->buf = &segment;
+		msg++;
+	}
+	msg->addr = DDC_ADDR;
+	msg->flags = 0;
+	msg->len = 1;
+	msg->buf = &offset;
+	msg++;
+	msg->addr = DDC_ADDR;
+	msg->flags = I2C_M_RD;
+	msg->len = EDID_BLOCK;
+	msg->buf = buf;
+	msg++;
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = msg - msgs;
+	return ioctl(file, I2C_RDWR, &rdwr) == (int)rdwr.nmsgs ? 0 : -errno;
+}
+
+static int good_signature(const unsigned char *bytes)
+{
+	static const unsigned char header[8] = {
+		0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00
+	};
+
+	return !memcmp(bytes, header, sizeof(header));
+}
+
+static int read_edid_bus(int file, struct edid *edid)
+{
+	unsigned char *bytes;
+	int res, block, blocks;
+
+	bytes = malloc(EDID_BLOCK);
+	if (!bytes)
+		return -ENOMEM;
+	edid->bytes = bytes;
+
+	res = read_block(file, 0, bytes);
+	if (res < 0)
+		return res;
+	if (!good_signature(bytes))
+		return -ENOMSG;
+
+	/* Byte 126 is the number of extension blocks */
+	blocks = 1 + bytes[0x7e];
+	bytes = realloc(bytes, blocks * EDID_BLOCK);
+	if (!bytes)
+		return -ENOMEM;
+	edid->bytes = bytes;
+	edid->blocks = 1;
+
+	for (block = 1; block < blocks; block++) {
+		res = read_block(file, block, bytes + block * EDID_BLOCK);
+		if (res < 0)
+			return res;
+		edid->blocks++;
+	}
+
+	return 0;
+}
+
+static void *worker_run(void *arg)
+{
+	struct worker *w = arg;
+	unsigned long funcs;
+	int file;
+
+	file = i2c_open_i2c_dev(w->i2cbus, w->name, sizeof(w->name), 0);
+	if (file < 0) {
+		w->edid.error = -ENODEV;
+		return NULL;
+	}
+	if (i2c_get_functionality(file, &funcs) < 0
+	 || !(funcs & I2C_FUNC_I2C)) {
+		close(file);
+		w->edid.error = -EOPNOTSUPP;
+		return NULL;
+	}
+
+	w->edid.error = read_edid_bus(file, &w->edid);
+	close(file);
+	return NULL;
+}
+
+static int read_edid_file(const char *path, struct edid *edid)
+{
+	unsigned char *bytes = NULL, *tmp;
+	int fd, res, len = 0, size = 0;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	/* sysfs attributes don't report their size, read until EOF */
+	do {
+		if (len == size) {
+			size += EDID_BLOCK;
+			tmp = realloc(bytes, size);
+			if (!tmp) {
+				res = -ENOMEM;
+				break;
+			}
+			bytes = tmp;
+		}
+		res = read(fd, bytes + len, size - len);
+		if (res > 0)
+			len += res;
+		else if (res < 0)
+			res = -errno;
+	} while (res > 0 && len < EDID_MAX_BLOCKS * EDID_BLOCK);
+	close(fd);
+
+	edid->bytes = bytes;
+	if (res < 0)
+		return res;
+	if (len < EDID_BLOCK || !good_signature(bytes))
+		return -ENOMSG;
+
+	/* Ignore trailing data and missing extension blocks */
+	edid->blocks = 1 + bytes[0x7e];
+	if (edid->blocks > len / EDID_BLOCK)
+		edid->blocks = len / EDID_BLOCK;
+	return 0;
+}
+
+/*
+ * Decoding, following ddcmon
+ */
+
+static int block_checksum_ok(const unsigned char *bytes)
+{
+	unsigned char cs = 0;
+	int i;
+
+	for (i = 0; i < EDID_BLOCK; i++)
+		cs += bytes[i];
+	return cs == 0;
+}
+
+static unsigned int extract_word(const unsigned char *bytes, int offset)
+{
+	return bytes[offset] | (bytes[offset + 1] << 8);
+}
+
+static unsigned int extract_dword(const unsigned char *bytes, int offset)
+{
+	return bytes[offset] | (bytes[offset + 1] << 8)
+	     | (bytes[offset + 2] << 16) | ((unsigned)bytes[offset + 3] << 24);
+}
+
+static void extract_manufacturer(const unsigned char *bytes, char *id)
+{
+	unsigned int i = bytes[0x09] | (bytes[0x08] << 8);
+
+	id[0] = ((i >> 10) & 0x1f) + 'A' - 1;
+	id[1] = ((i >> 5) & 0x1f) + 'A' - 1;
+	id[2] = (i & 0x1f) + 'A' - 1;
+	id[3] = '\0';
+}
+
+static const char *extract_display_input(const unsigned char *bytes)
+{
+	static const char *const analog[4] = {
+		"Analog (0.700V/0.300V)", "Analog (0.714V/0.286V)",
+		"Analog (1.000V/0.400V)", "Analog (0.700V/0.000V)",
+	};
+
+	if (bytes[0x14] & 0x80)
+		return "Digital";
+	return analog[(bytes[0x14] & 0x60) >> 5];
+}
+
+static const char *const dpms_modes[3] = {
+	"Active Off", "Suspend", "Standby",
+};
+
+static const char *extract_color_mode(const unsigned char *bytes)
+{
+	static const char *const mode[3] = {
+		"Monochrome", "RGB Multicolor", "Non-RGB Multicolor",
+	};
+
+	return mode[(bytes[0x18] >> 3) & 0x03];
+}
+
+static int color_mode_defined(const unsigned char *bytes)
+{
+	return (bytes[0x18] & 0x18) != 0x18;
+}
+
+/* Modes are unique by size, refresh rate and interlacing */
+static void add_timing(struct edid *edid, unsigned int width,
+		       unsigned int height, unsigned int refresh,
+		       int interlaced)
+{
+	struct timing *t;
+	int i;
+
+	for (i = 0; i < edid->ntimings; i++) {
+		t = &edid->timings[i];
+		if (t->width == width && t->height == height
+		 && t->refresh == refresh && t->interlaced == interlaced)
+			return;
+	}
+	if (edid->ntimings == MAX_TIMINGS)
+		return;
+
+	t = &edid->timings[edid->ntimings++];
+	t->width = width;
+	t->height = height;
+	t->refresh = refresh;
+	t->interlaced = interlaced;
+}
+
+static void add_standard_timing(struct edid *edid, unsigned char byte0,
+				unsigned char byte1)
+{
+	const unsigned int *scale;
+	unsigned int width;
+
+	/* Unused slot */
+	if (byte0 == byte1
+	 && (byte0 == 0x01 || byte0 == 0x00 || byte0 == 0x20))
+		return;
+
+	scale = byte1 >> 6 ? standard_scales[byte1 >> 6] : edid->scale0;
+	width = (byte0 + 31) * 8;
+	add_timing(edid, width, width * scale[0] / scale[1],
+		   60 + (byte1 & 0x3f), 0);
+}
+
+static void extract_string(const unsigned char *desc, char *s, size_t size)
+{
+	size_t len = strlen(s);
+	int i;
+
+	for (i = 5; i < 18; i++) {
+		if (desc[i] == 0x0a || desc[i] == 0x00)
+			break;
+		if (desc[i] >= 32 && desc[i] < 127 && len + 1 < size)
+			s[len++] = desc[i];
+	}
+	s[len] = '\0';
+
+	/* Strip trailing spaces of this descriptor's string */
+	while (len && s[len - 1] == ' ')
+		s[--len] = '\0';
+}
+
+/*
+ * 18-byte descriptors are either detailed timings, or one of:
+ *   0x00, 0x00, 0x00, 0xfa: Additional standard timings block
+ *   0x00, 0x00, 0x00, 0xfc: Monitor block
+ *   0x00, 0x00, 0x00, 0xfd: Limits block
+ *   0x00, 0x00, 0x00, 0xfe: Ascii block
+ *   0x00, 0x00, 0x00, 0xff: Serial block
+ */
+static void extract_descriptor(struct edid *edid, const unsigned char *desc)
+{
+	unsigned int width, height, hblank, vblank;
+	unsigned long long clock, area;
+	int i;
+
+	if (desc[0] == 0x00 && desc[1] == 0x00 && desc[2] == 0x00
+	 && desc[4] == 0x00) {
+		switch (desc[3]) {
+		case 0xfa:
+			for (i = 5; i < 17; i += 2)
+				add_standard_timing(edid, desc[i], desc[i + 1]);
+			break;
+		case 0xfc:
+			edid->has_monitor = 1;
+			extract_string(desc, edid->monitor,
+				       sizeof(edid->monitor));
+			break;
+		case 0xfd:
+			edid->limits.valid = 1;
+			edid->limits.vsync_min = desc[5];
+			edid->limits.vsync_max = desc[6];
+			edid->limits.hsync_min = desc[7];
+			edid->limits.hsync_max = desc[8];
+			edid->limits.clock_max = desc[9];
+			break;
+		case 0xfe:
+			extract_string(desc, edid->ascii, sizeof(edid->ascii));
+			break;
+		case 0xff:
+			extract_string(desc, edid->serial,
+				       sizeof(edid->serial));
+			break;
+		}
+		return;
+	}
+
+	/* Detailed Timing */
+	width = desc[2] + ((desc[4] & 0xf0) << 4);
+	height = desc[5] + ((desc[7] & 0xf0) << 4);
+	clock = extract_word(desc, 0) * 10000ULL;
+	hblank = desc[3] + ((desc[4] & 0x0f) << 8);
+	vblank = desc[6] + ((desc[7] & 0x0f) << 8);
+	area = (unsigned long long)(width + hblank) * (height + vblank);
+	if (!area)	/* Should not happen, but... */
+		return;
+	/* Proper rounding */
+	add_timing(edid, width, height, (2 * clock + area) / (2 * area), 0);
+}
+
+/*
+ * CEA-861 extensions carry more detailed timing descriptors, from the
+ * offset in byte 2 up to the checksum.
+ */
+static void extract_cea_extension(struct edid *edid,
+				  const unsigned char *block)
+{
+	int offset;
+
+	if (block[2] < 4)
+		return;
+	for (offset = block[2]; offset + 18 <= EDID_BLOCK - 1; offset += 18) {
+		if (!block[offset] && !block[offset + 1])
+			break;	/* padding */
+		extract_descriptor(edid, block + offset);
+	}
+}
+
+/* Interlaced modes count for half their frequency */
+static int cmp_timing(const void *a, const void *b)
+{
+	const struct timing *ta = a, *tb = b;
+	unsigned int fa, fb;
+
+	if (ta->width != tb->width)
+		return ta->width < tb->width ? -1 : 1;
+	if (ta->height != tb->height)
+		return ta->height < tb->height ? -1 : 1;
+	fa = ta->refresh * (ta->interlaced ? 1 : 2);
+	fb = tb->refresh * (tb->interlaced ? 1 : 2);
+	if (fa != fb)
+		return fa < fb ? -1 : 1;
+	return 0;
+}
+
+static void decode_edid(struct edid *edid)
+{
+	const unsigned char *bytes = edid->bytes;
+	unsigned int established_bits;
+	int i, offset;
+
+	if (bytes[0x12] > 1 || bytes[0x13] > 2) {
+		edid->scale0[0] = 16;
+		edid->scale0[1] = 10;
+	} else {
+		edid->scale0[0] = 1;
+		edid->scale0[1] = 1;
+	}
+
+	for (offset = 0x36; offset < 0x7e; offset += 18)
+		extract_descriptor(edid, bytes + offset);
+
+	/* Established Timings */
+	established_bits = bytes[0x23] | (bytes[0x24] << 8)
+			 | (bytes[0x25] << 16);
+	for (i = 0; i < 24; i++) {
+		if (!established[i].width || !(established_bits & (1 << i)))
+			continue;
+		add_timing(edid, established[i].width, established[i].height,
+			   established[i].refresh, established[i].interlaced);
+	}
+
+	/* Standard Timings */
+	for (offset = 0x26; offset < 0x36; offset += 2)
+		add_standard_timing(edid, bytes[offset], bytes[offset + 1]);
+
+	for (i = 1; i < edid->blocks; i++) {
+		if (bytes[i * EDID_BLOCK] == 0x02)
+			extract_cea_extension(edid, bytes + i * EDID_BLOCK);
+	}
+
+	qsort(edid->timings, edid->ntimings, sizeof(struct timing),
+	      cmp_timing);
+}
+
+/*
+ * Text output, formatted like ddcmon
+ */
+
+static void print_line(const char *label, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static void print_line(const char *label, const char *fmt, ...)
+{
+	char buf[32];
+	va_list ap;
+
+	snprintf(buf, sizeof(buf), "%s:", label);
+	printf("%-24s", buf);
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	putchar('\n');
+}
+
+static void print_text(const struct edid *edid)
+{
+	const unsigned char *bytes = edid->bytes;
+	char id[4];
+	unsigned int serial;
+	int i, n;
+
+	print_line("Source", "%s", edid->source);
+	print_line("Checksum", "%s",
+		   block_checksum_ok(bytes) ? "OK" : "Not OK");
+	print_line("EDID Version", "%u.%u", bytes[0x12], bytes[0x13]);
+	for (i = 1; i < edid->blocks; i++)
+		print_line("Extension Block", "%d, tag 0x%02x, checksum %s", i,
+			   bytes[i * EDID_BLOCK],
+			   block_checksum_ok(bytes + i * EDID_BLOCK) ?
+			   "OK" : "Not OK");
+
+	extract_manufacturer(bytes, id);
+	print_line("Manufacturer ID", "%s", id);
+	print_line("Model Number", "0x%04X", extract_word(bytes, 0x0a));
+	if (edid->has_monitor)
+		print_line("Model Name", "%s", edid->monitor);
+
+	if (edid->serial[0])
+		print_line("Serial Number", "%s", edid->serial);
+	else if ((serial = extract_dword(bytes, 0x0c)))
+		print_line("Serial Number", "%u", serial);
+
+	print_line("Manufacture Time", "%u-W%02u", 1990 + bytes[0x11],
+		   bytes[0x10]);
+	print_line("Display Input", "%s", extract_display_input(bytes));
+	print_line("Monitor Size (cm)", "%ux%u", bytes[0x15], bytes[0x16]);
+	print_line("Gamma Factor", "%.2f", 1 + bytes[0x17] / 100.0);
+
+	printf("%-24s", "DPMS Modes:");
+	for (i = 0, n = 0; i < 3; i++)
+		if (bytes[0x18] & (0x20 << i))
+			printf("%s%s", n++ ? ", " : "", dpms_modes[i]);
+	printf("%s\n", n ? "" : "None supported");
+
+	if (color_mode_defined(bytes))
+		print_line("Color Mode", "%s", extract_color_mode(bytes));
+	if (edid->ascii[0])
+		print_line("Additional Info", "%s", edid->ascii);
+
+	if (edid->limits.valid) {
+		print_line("Vertical Sync (Hz)", "%u-%u",
+			   edid->limits.vsync_min, edid->limits.vsync_max);
+		print_line("Horizontal Sync (kHz)", "%u-%u",
+			   edid->limits.hsync_min, edid->limits.hsync_max);
+		if (edid->limits.clock_max != 0xff)
+			print_line("Max Pixel Clock (MHz)", "%u",
+				   edid->limits.clock_max * 10);
+	}
+
+	for (i = 0; i < edid->ntimings; i++)
+		print_line("Timing", "%ux%u @ %u Hz%s",
+			   edid->timings[i].width, edid->timings[i].height,
+			   edid->timings[i].refresh,
+			   edid->timings[i].interlaced ? " (interlaced)" : "");
+	putchar('\n');
+}
+
+/*
+ * JSON output: one object per monitor
+ */
+
+static void print_json_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			putchar('\\');
+		putchar(*s);
+	}
+	putchar('"');
+}
+
+static void print_json(const struct edid *edid, int first)
+{
+	const unsigned char *bytes = edid->bytes;
+	char id[4];
+	int i, n;
+
+	printf("%s\n  {\n    \"source\": ", first ? "" : ",");
+	print_json_string(edid->source);
+	printf(",\n    \"checksum_ok\": %s,\n",
+	       block_checksum_ok(bytes) ? "true" : "false");
+	printf("    \"version\": \"%u.%u\",\n", bytes[0x12], bytes[0x13]);
+
+	printf("    \"extensions\": [");
+	for (i = 1; i < edid->blocks; i++)
+		printf("%s\n      { \"tag\": %u, \"checksum_ok\": %s }",
+		       i > 1 ? "," : "", bytes[i * EDID_BLOCK],
+		       block_checksum_ok(bytes + i * EDID_BLOCK) ?
+		       "true" : "false");
+	printf("%s],\n", edid->blocks > 1 ? "\n    " : "");
+
+	extract_manufacturer(bytes, id);
+	printf("    \"manufacturer\": \"%s\",\n", id);
+	printf("    \"model\": %u,\n", extract_word(bytes, 0x0a));
+	if (edid->has_monitor) {
+		printf("    \"model_name\": ");
+		print_json_string(edid->monitor);
+		printf(",\n");
+	}
+	if (edid->serial[0]) {
+		printf("    \"serial\": ");
+		print_json_string(edid->serial);
+		printf(",\n");
+	} else if (extract_dword(bytes, 0x0c)) {
+		printf("    \"serial\": \"%u\",\n", extract_dword(bytes, 0x0c));
+	}
+	printf("    \"manufacture_year\": %u,\n", 1990 + bytes[0x11]);
+	printf("    \"manufacture_week\": %u,\n", bytes[0x10]);
+	printf("    \"display_input\": \"%s\",\n",
+	       extract_display_input(bytes));
+	printf("    \"size_cm\": [%u, %u],\n", bytes[0x15], bytes[0x16]);
+	printf("    \"gamma\": %.2f,\n", 1 + bytes[0x17] / 100.0);
+
+	printf("    \"dpms_modes\": [");
+	for (i = 0, n = 0; i < 3; i++)
+		if (bytes[0x18] & (0x20 << i))
+			printf("%s\"%s\"", n++ ? ", " : "", dpms_modes[i]);
+	printf("],\n");
+
+	if (color_mode_defined(bytes))
+		printf("    \"color_mode\": \"%s\",\n",
+		       extract_color_mode(bytes));
+	if (edid->ascii[0]) {
+		printf("    \"additional_info\": ");
+		print_json_string(edid->ascii);
+		printf(",\n");
+	}
+	if (edid->limits.valid) {
+		printf("    \"limits\": { \"vsync_min\": %u, \"vsync_max\": %u, "
+		       "\"hsync_min\": %u, \"hsync_max\": %u",
+		       edid->limits.vsync_min, edid->limits.vsync_max,
+		       edid->limits.hsync_min, edid->limits.hsync_max);
+		if (edid->limits.clock_max != 0xff)
+			printf(", \"clock_max\": %u",
+			       edid->limits.clock_max * 10);
+		printf(" },\n");
+	}
+
+	printf("    \"timings\": [");
+	for (i = 0; i < edid->ntimings; i++)
+		printf("%s\n      { \"width\": %u, \"height\": %u, "
+		       "\"refresh\": %u, \"interlaced\": %s }",
+		       i ? "," : "", edid->timings[i].width,
+		       edid->timings[i].height, edid->timings[i].refresh,
+		       edid->timings[i].interlaced ? "true" : "false");
+	printf("%s]\n  }", edid->ntimings ? "\n    " : "");
+}
+
+/* Default to all adapters able to do plain I2C, as DDC buses are */
+static int add_i2c_adapters(struct worker **workers, int *n)
+{
+	struct i2c_adap *adapters;
+	int count;
+
+	adapters = gather_i2c_busses();
+	if (adapters == NULL)
+		return -1;
+
+	for (count = 0; adapters[count].name; count++) {
+		if (strcmp(adapters[count].funcs, "i2c"))
+			continue;
+		*workers = realloc(*workers, (*n + 1) * sizeof(**workers));
+		if (!*workers) {
+			free_adapters(adapters);
+			return -1;
+		}
+		memset(&(*workers)[*n], 0, sizeof(**workers));
+		(*workers)[(*n)++].i2cbus = adapters[count].nr;
+	}
+
+	free_adapters(adapters);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct worker *workers = NULL;
+	int i, n = 0, opt, found = 0, errors = 0;
+	int json = 0, files = 0, yes = 0, explicit;
+
+	while ((opt = getopt(argc, argv, "hjrVy")) != -1) {
+		switch (opt) {
+		case 'j':
+			json = 1;
+			break;
+		case 'r':
+			files = 1;
+			break;
+		case 'V':
+			fprintf(stderr, "ddcread version %s\n", VERSION);
+			exit(0);
+		case 'y':
+			yes = 1;
+			break;
+		case 'h':
+			help();
+			exit(0);
+		default:
+			help();
+			exit(1);
+		}
+	}
+
+	explicit = optind < argc;
+	if (files && !explicit) {
+		help();
+		exit(1);
+	}
+
+	if (explicit) {
+		workers = calloc(argc - optind, sizeof(*workers));
+		if (!workers) {
+			fprintf(stderr, "Error: Out of memory!\n");
+			exit(1);
+		}
+		for (i = optind; i < argc; i++, n++) {
+			if (files) {
+				workers[n].edid.source = argv[i];
+				continue;
+			}
+			workers[n].i2cbus = i2c_lookup_i2c_bus(argv[i]);
+			if (workers[n].i2cbus < 0) {
+				help();
+				exit(1);
+			}
+		}
+	} else if (add_i2c_adapters(&workers, &n)) {
+		fprintf(stderr, "Error: Out of memory!\n");
+		exit(1);
+	}
+
+	if (!n) {
+		fprintf(stderr, "Error: No I2C adapter found\n");
+		exit(1);
+	}
+
+	if (!files && !yes) {
+		fprintf(stderr, "WARNING! This program can confuse your I2C "
+			"bus, cause data loss and worse!\n");
+		fprintf(stderr, "I will read address 0x%02x on %d bus%s:",
+			DDC_ADDR, n, n > 1 ? "ses" : "");
+		for (i = 0; i < n; i++)
+			fprintf(stderr, " %d", workers[i].i2cbus);
+		fprintf(stderr, "\nContinue? [Y/n] ");
+		fflush(stderr);
+		if (!user_ack(1)) {
+			fprintf(stderr, "Aborting on user request.\n");
+			exit(0);
+		}
+	}
+
+	if (files) {
+		for (i = 0; i < n; i++)
+			workers[i].edid.error =
+				read_edid_file(workers[i].edid.source,
+					       &workers[i].edid);
+	} else {
+		for (i = 0; i < n; i++) {
+			workers[i].edid.source = workers[i].name;
+			snprintf(workers[i].name, sizeof(workers[i].name),
+				 "/dev/i2c-%d", workers[i].i2cbus);
+			if (pthread_create(&workers[i].thread, NULL,
+					   worker_run, &workers[i])) {
+				workers[i].edid.error = -EAGAIN;
+				continue;
+			}
+			workers[i].started = 1;
+		}
+		for (i = 0; i < n; i++)
+			if (workers[i].started)
+				pthread_join(workers[i].thread, NULL);
+	}
+
+	if (json)
+		printf("[");
+	for (i = 0; i < n; i++) {
+		struct edid *edid = &workers[i].edid;
+
+		/* Scanning all buses, most of them have no monitor */
+		if (edid->error) {
+			if (explicit) {
+				fprintf(stderr, "Error: No EDID found on %s: "
+					"%s\n", edid->source,
+					edid->error == -ENOMSG ?
+					"Bad EDID header" :
+					strerror(-edid->error));
+				errors++;
+			}
+			free(edid->bytes);
+			continue;
+		}
+
+		decode_edid(edid);
+		if (json)
+			print_json(edid, !found);
+		else
+			print_text(edid);
+		found++;
+		free(edid->bytes);
+	}
+	if (json)
+		printf("%s]\n", found ? "\n" : "");
+
+	if (!found && !explicit)
+		fprintf(stderr, "No EDID EEPROM found.\n");
+
+	free(workers);
+	exit(errors || !found ? 1 : 0);
+}
@@ -0,0 +1,374 @@
+/*
+    decode-spd - decode memory module SPD EEPROMs
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+/*
+ * A compiled counterpart of decode-dimms: same fields and wording, but
+ * the whole DIMM list is read and decoded without spawning anything,
+ * and the result can be emitted as JSON for inventory tools.
+ */
+
+#include <sys/types.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "spd.h"
+#include "../version.h"
+
+static const char *const sysfs_dirs[] = {
+	"/sys/bus/i2c/drivers/eeprom",
+	"/sys/bus/i2c/drivers/at24",
+};
+
+struct dimm {
+	char *file;
+	unsigned char bytes[SPD_MAX_SIZE];
+	int len;
+	struct spd_decoded spd;
+};
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: decode-spd [-c] [-j] [FILE|DIR]...\n"
+		"  -c  Decode completely even if checksum fails\n"
+		"  -j  Print JSON output\n"
+		"  FILE is a binary SPD EEPROM image, DIR a sysfs I2C device\n"
+		"  directory. By default, all SPD EEPROMs bound to the eeprom\n"
+		"  or at24 driver are decoded.\n");
+}
+
+static int cmp_dimm(const void *a, const void *b)
+{
+	return strcmp(((const struct dimm *)a)->file,
+		      ((const struct dimm *)b)->file);
+}
+
+static int add_dimm(struct dimm **dimms, int *n, const char *file)
+{
+	struct dimm *d;
+
+	d = realloc(*dimms, (*n + 1) * sizeof(**dimms));
+	if (!d)
+		return -1;
+	*dimms = d;
+	d = &(*dimms)[*n];
+	memset(d, 0, sizeof(*d));
+	d->file = strdup(file);
+	if (!d->file)
+		return -1;
+	(*n)++;
+	return 0;
+}
+
+/* Device name must be eeprom (driver eeprom) or spd (driver at24) */
+static int is_spd_device(const char *path)
+{
+	char attr[PATH_MAX], name[32];
+	FILE *f;
+	int res = 0;
+
+	if (snprintf(attr, sizeof(attr), "%s/name", path)
+	    >= (int)sizeof(attr))
+		return 0;
+	f = fopen(attr, "r");
+	if (!f)
+		return 0;
+	if (fgets(name, sizeof(name), f)) {
+		name[strcspn(name, "\n")] = '\0';
+		res = !strcmp(name, "eeprom") || !strcmp(name, "spd");
+	}
+	fclose(f);
+	return res;
+}
+
+/* We look for I2C devices like 0-0050 or 2-0051 */
+static int is_i2c_device(const char *name)
+{
+	const char *s = name;
+
+	if (!isdigit(*s))
+		return 0;
+	while (isdigit(*s))
+		s++;
+	if (*s++ != '-' || !isxdigit(*s))
+		return 0;
+	while (isxdigit(*s))
+		s++;
+	return *s == '\0';
+}
+
+static int scan_sysfs(struct dimm **dimms, int *n)
+{
+	char path[PATH_MAX];
+	struct dirent *de;
+	DIR *dir;
+	int i, opened = 0;
+
+	for (i = 0; i < (int)(sizeof(sysfs_dirs) / sizeof(sysfs_dirs[0]));
+	     i++) {
+		dir = opendir(sysfs_dirs[i]);
+		if (!dir)
+			continue;
+		opened++;
+
+		while ((de = readdir(dir)) != NULL) {
+			if (!is_i2c_device(de->d_name))
+				continue;
+			snprintf(path, sizeof(path), "%s/%s", sysfs_dirs[i],
+				 de->d_name);
+			if (!is_spd_device(path))
+				continue;
+			if (add_dimm(dimms, n, path)) {
+				closedir(dir);
+				return -ENOMEM;
+			}
+		}
+		closedir(dir);
+	}
+
+	if (!opened) {
+		fprintf(stderr, "No EEPROM found, try loading the eeprom or "
+			"at24 module\n");
+		return -ENOENT;
+	}
+
+	qsort(*dimms, *n, sizeof(**dimms), cmp_dimm);
+	return 0;
+}
+
+/*
+ * Text output, formatted like decode-dimms
+ */
+
+static void print_field(const struct spd_field *field)
+{
+	const char *value = field->value, *eol;
+	const char *label = field->label;
+
+	/* Multi-line values continue under the value column */
+	do {
+		eol = strchr(value, '\n');
+		printf("%-47s  %.*s\n", label,
+		       eol ? (int)(eol - value) : (int)strlen(value), value);
+		label = "";
+		value = eol + 1;
+	} while (eol);
+}
+
+/* The bank can be guessed from the address of sysfs devices */
+static void print_bank(const char *file)
+{
+	const char *dash = strrchr(file, '-');
+	char *end;
+	long addr;
+
+	if (!dash || !dash[1] || strchr(dash, '/'))
+		return;
+	addr = strtol(dash + 1, &end, 16);
+	if (*end || addr < 0x50 || addr > 0x57)
+		return;
+	printf("%-47s  bank %ld\n", "Guessing DIMM is in", addr - 0x50 + 1);
+}
+
+static void print_text(const struct dimm *dimms, int n)
+{
+	int i, j;
+
+	printf("# decode-spd version %s\n", VERSION);
+	printf("\nMemory Serial Presence Detect Decoder\n"
+	       "By Philip Edelbrock, Christian Zuckschwerdt, Burkart Lingner,\n"
+	       "Jean Delvare, Trent Piepho and others\n");
+
+	for (i = 0; i < n; i++) {
+		const struct spd_decoded *spd = &dimms[i].spd;
+
+		printf("\n\nDecoding EEPROM: %s\n", dimms[i].file);
+		print_bank(dimms[i].file);
+		for (j = 0; j < spd->nfields; j++) {
+			if (spd->fields[j].value)
+				print_field(&spd->fields[j]);
+			else
+				printf("\n---=== %s ===---\n",
+				       spd->fields[j].label);
+		}
+	}
+
+	printf("\n\nNumber of SDRAM DIMMs detected and decoded: %d\n", n);
+}
+
+/*
+ * JSON output: one object per DIMM, fields grouped by section
+ */
+
+static void print_json_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++) {
+		switch (*s) {
+		case '"':
+			fputs("\\\"", stdout);
+			break;
+		case '\\':
+			fputs("\\\\", stdout);
+			break;
+		case '\n':
+			fputs("\\n", stdout);
+			break;
+		default:
+			if ((unsigned char)*s < 0x20)
+				printf("\\u%04x", *s);
+			else
+				putchar(*s);
+		}
+	}
+	putchar('"');
+}
+
+static void print_json(const struct dimm *dimms, int n)
+{
+	int i, j, in_section;
+
+	printf("[");
+	for (i = 0; i < n; i++) {
+		const struct spd_decoded *spd = &dimms[i].spd;
+
+		printf("%s\n  {\n    \"eeprom\": ", i ? "," : "");
+		print_json_string(dimms[i].file);
+		printf(",\n    \"size\": %d,\n    \"type\": ", dimms[i].len);
+		print_json_string(spd->type);
+		printf(",\n    \"checksum_ok\": %s,\n    \"sections\": {",
+		       spd->checksum_ok ? "true" : "false");
+
+		in_section = 0;
+		for (j = 0; j < spd->nfields; j++) {
+			const struct spd_field *field = &spd->fields[j];
+
+			if (!field->value) {
+				printf("%s\n      ", in_section ?
+				       "\n      }," : "");
+				print_json_string(field->label);
+				printf(": {");
+				in_section = 1;
+				continue;
+			}
+			/* Fields before the first section are unexpected */
+			if (!in_section)
+				continue;
+			printf("%s\n        ", spd->fields[j - 1].value ?
+			       "," : "");
+			print_json_string(field->label);
+			printf(": ");
+			print_json_string(field->value);
+		}
+		printf("%s\n    }\n  }", in_section ? "\n      }" : "");
+	}
+	printf("%s]\n", n ? "\n" : "");
+}
+
+int main(int argc, char *argv[])
+{
+	struct dimm *dimms = NULL;
+	int i, n = 0, valid, res;
+	int ignore_checksum = 0, json = 0;
+
+	while ((i = getopt(argc, argv, "cjhV")) != -1) {
+		switch (i) {
+		case 'c':
+			ignore_checksum = 1;
+			break;
+		case 'j':
+			json = 1;
+			break;
+		case 'V':
+			fprintf(stderr, "decode-spd version %s\n", VERSION);
+			exit(0);
+		case 'h':
+			help();
+			exit(0);
+		default:
+			help();
+			exit(1);
+		}
+	}
+
+	if (optind < argc) {
+		for (i = optind; i < argc; i++) {
+			if (add_dimm(&dimms, &n, argv[i])) {
+				fprintf(stderr, "Error: Out of memory!\n");
+				exit(1);
+			}
+		}
+	} else {
+		res = scan_sysfs(&dimms, &n);
+		if (res == -ENOMEM)
+			fprintf(stderr, "Error: Out of memory!\n");
+		if (res)
+			exit(1);
+	}
+
+	/* Read and decode, dropping DIMMs which fail the checksum */
+	for (i = 0, valid = 0; i < n; i++) {
+		struct dimm *d = &dimms[i];
+
+		d->len = spd_read(d->file, d->bytes, SPD_MAX_SIZE);
+		if (d->len < 0) {
+			fprintf(stderr, "Error: Could not read %s: %s\n",
+				d->file, strerror(-d->len));
+			free(d->file);
+			continue;
+		}
+
+		res = spd_decode(d->bytes, d->len, &d->spd);
+		if (res < 0) {
+			fprintf(stderr, "Error: Could not decode %s: %s\n",
+				d->file, strerror(-res));
+			free(d->file);
+			continue;
+		}
+
+		if (!d->spd.checksum_ok && !ignore_checksum) {
+			spd_free(&d->spd);
+			free(d->file);
+			continue;
+		}
+
+		if (valid != i)
+			dimms[valid] = *d;
+		valid++;
+	}
+
+	if (json)
+		print_json(dimms, valid);
+	else
+		print_text(dimms, valid);
+
+	for (i = 0; i < valid; i++) {
+		spd_free(&dimms[i].spd);
+		free(dimms[i].file);
+	}
+	free(dimms);
+
+	exit(0);
+}
@@ -0,0 +1,402 @@
+/*
+    read-spd - read memory module SPD EEPROMs from all SMBus adapters
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+/*
+ * SPD EEPROMs are slow to read, and the eeprom driver reads them one
+ * byte or word at a time, one DIMM after the other. This tool reads
+ * them directly, one thread per adapter so that all memory channels
+ * are read concurrently, using the largest transfers the adapter
+ * supports. The images can then be decoded with decode-spd or
+ * decode-dimms -r.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/busses.h>
+#include <i2c/smbus.h>
+#include <i2c/xfer.h>
+#include "../tools/i2cbusses.h"
+#include "../tools/util.h"
+#include "spd.h"
+#include "../version.h"
+
+#define SPD_FIRST	0x50
+#define SPD_LAST	0x57
+#define SPD_COUNT	(SPD_LAST - SPD_FIRST + 1)
+
+/* How the EEPROM data was read, fastest first */
+enum spd_method {
+	METHOD_I2C,		/* one I2C_RDWR transfer */
+	METHOD_I2C_BLOCK,	/* SMBus I2C block reads, 32 bytes each */
+	METHOD_BYTE,		/* SMBus read byte data, one at a time */
+};
+
+static const char *const method_names[] = {
+	"i2c transfer",
+	"i2c block reads",
+	"byte reads",
+};
+
+struct spd_image {
+	int address;
+	int len;		/* 0 if no EEPROM found */
+	enum spd_method method;
+	unsigned char bytes[SPD_MAX_SIZE];
+};
+
+struct worker {
+	pthread_t thread;
+	int i2cbus;
+	int force;
+	int started;
+	int error;		/* negative errno if the bus couldn't be used */
+	int failed;		/* EEPROMs which answered but couldn't be read */
+	long long ns;		/* time spent reading */
+	struct spd_image images[SPD_COUNT];
+};
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: read-spd [-y] [-f] [-d DIR] [I2CBUS...]\n"
+		"  I2CBUS is an integer or an I2C bus name\n"
+		"  -d DIR  Directory to save images into (default: current)\n"
+		"  -f      Force access to EEPROMs bound to a driver\n"
+		"  -y      Disable interactive mode\n"
+		"  By default, all SMBus adapters are scanned, in parallel.\n"
+		"  Images are saved as I2CBUS-00ADDRESS.bin, for decode-spd or\n"
+		"  decode-dimms -r.\n");
+}
+
+static long long timespec_ns(const struct timespec *ts)
+{
+	return (long long)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static int read_i2c_block(int file, int offset, int len, unsigned char *buf)
+{
+	int res, chunk;
+
+	while (len) {
+		chunk = len < I2C_SMBUS_BLOCK_MAX ? len : I2C_SMBUS_BLOCK_MAX;
+		res = i2c_smbus_read_i2c_block_data(file, offset, chunk, buf);
+		if (res < 0)
+			return res;
+		if (res != chunk)
+			return -EIO;
+		offset += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+static int read_bytes(int file, int offset, int len, unsigned char *buf)
+{
+	int res;
+
+	while (len--) {
+		res = i2c_smbus_read_byte_data(file, offset++);
+		if (res < 0)
+			return res;
+		*buf++ = res;
+	}
+
+	return 0;
+}
+
+static int read_range(int file, int address, enum spd_method method,
+		      int offset, int len, unsigned char *buf)
+{
+	int res;
+
+	switch (method) {
+	case METHOD_I2C:
+		res = i2c_xfer_read(file, address, 0, offset, buf, len);
+		return res < 0 ? res : 0;
+	case METHOD_I2C_BLOCK:
+		return read_i2c_block(file, offset, len, buf);
+	default:
+		return read_bytes(file, offset, len, buf);
+	}
+}
+
+/*
+ * Read the first 128 bytes, then whatever else the SPD data says is
+ * used. If a method fails, fall back to the next (slower) one, as
+ * adapters don't always support all the transfers they claim to.
+ */
+static int read_image(int file, unsigned long funcs, struct spd_image *image)
+{
+	enum spd_method method;
+	int used;
+
+	/* No need to go further if nothing answers */
+	if (i2c_smbus_read_byte_data(file, 0) < 0)
+		return 0;
+
+	for (method = METHOD_I2C; method <= METHOD_BYTE; method++) {
+		if (method == METHOD_I2C && !(funcs & I2C_FUNC_I2C))
+			continue;
+		if (method == METHOD_I2C_BLOCK
+		 && !(funcs & I2C_FUNC_SMBUS_READ_I2C_BLOCK))
+			continue;
+
+		if (read_range(file, image->address, method, 0, 128,
+			       image->bytes) < 0)
+			continue;
+		used = spd_used_size(image->bytes);
+		if (used > 128
+		 && read_range(file, image->address, method, 128, used - 128,
+			       image->bytes + 128) < 0)
+			continue;
+
+		image->method = method;
+		image->len = used;
+		return used;
+	}
+
+	return -EIO;
+}
+
+static void *worker_run(void *arg)
+{
+	struct worker *w = arg;
+	struct timespec start, end;
+	unsigned long funcs;
+	char filename[20];
+	int file, i, res;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	file = i2c_open_i2c_dev(w->i2cbus, filename, sizeof(filename), 0);
+	if (file < 0) {
+		w->error = -ENODEV;
+		return NULL;
+	}
+	if (i2c_get_functionality(file, &funcs) < 0
+	 || !(funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)) {
+		fprintf(stderr, "Error: %s can't do SMBus read byte data\n",
+			filename);
+		close(file);
+		w->error = -EOPNOTSUPP;
+		return NULL;
+	}
+
+	for (i = 0; i < SPD_COUNT; i++) {
+		w->images[i].address = SPD_FIRST + i;
+
+		/* Don't fight with a driver unless told so */
+		if (i2c_set_slave_addr(file, SPD_FIRST + i, w->force) < 0)
+			continue;
+
+		res = read_image(file, funcs, &w->images[i]);
+		if (res < 0) {
+			fprintf(stderr, "Error: Failed to read SPD EEPROM "
+				"%d-%04x: %s\n", w->i2cbus, SPD_FIRST + i,
+				strerror(-res));
+			w->failed++;
+		}
+	}
+	close(file);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	w->ns = timespec_ns(&end) - timespec_ns(&start);
+	return NULL;
+}
+
+static int save_image(const char *dir, int i2cbus,
+		      const struct spd_image *image)
+{
+	char path[PATH_MAX];
+	FILE *f;
+	int res = 0;
+
+	snprintf(path, sizeof(path), "%s/%d-%04x.bin", dir, i2cbus,
+		 image->address);
+	f = fopen(path, "wb");
+	if (!f) {
+		fprintf(stderr, "Error: Could not create %s: %s\n", path,
+			strerror(errno));
+		return -1;
+	}
+	if (fwrite(image->bytes, 1, image->len, f) != (size_t)image->len)
+		res = -1;
+	if (fclose(f))
+		res = -1;
+	if (res) {
+		fprintf(stderr, "Error: Could not write %s\n", path);
+		return -1;
+	}
+
+	printf("%s: %d bytes, %s\n", path, image->len,
+	       method_names[image->method]);
+	return 0;
+}
+
+/* Default to all SMBus adapters, the ones memory modules hang off */
+static int add_smbus_adapters(struct worker **workers, int *n)
+{
+	struct i2c_adap *adapters;
+	int count;
+
+	adapters = gather_i2c_busses();
+	if (adapters == NULL)
+		return -1;
+
+	for (count = 0; adapters[count].name; count++) {
+		if (strcmp(adapters[count].funcs, "smbus"))
+			continue;
+		*workers = realloc(*workers, (*n + 1) * sizeof(**workers));
+		if (!*workers) {
+			free_adapters(adapters);
+			return -1;
+		}
+		memset(&(*workers)[*n], 0, sizeof(**workers));
+		(*workers)[(*n)++].i2cbus = adapters[count].nr;
+	}
+
+	free_adapters(adapters);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct worker *workers = NULL;
+	struct timespec start, end;
+	const char *dir = ".";
+	int i, j, n = 0, opt, found = 0, errors = 0;
+	int yes = 0, force = 0;
+
+	while ((opt = getopt(argc, argv, "d:fhVy")) != -1) {
+		switch (opt) {
+		case 'd':
+			dir = optarg;
+			break;
+		case 'f':
+			force = 1;
+			break;
+		case 'V':
+			fprintf(stderr, "read-spd version %s\n", VERSION);
+			exit(0);
+		case 'y':
+			yes = 1;
+			break;
+		case 'h':
+			help();
+			exit(0);
+		default:
+			help();
+			exit(1);
+		}
+	}
+
+	if (optind < argc) {
+		workers = calloc(argc - optind, sizeof(*workers));
+		if (!workers) {
+			fprintf(stderr, "Error: Out of memory!\n");
+			exit(1);
+		}
+		for (i = optind; i < argc; i++) {
+			workers[n].i2cbus = i2c_lookup_i2c_bus(argv[i]);
+			if (workers[n].i2cbus < 0) {
+				help();
+				exit(1);
+			}
+			n++;
+		}
+	} else if (add_smbus_adapters(&workers, &n)) {
+		fprintf(stderr, "Error: Out of memory!\n");
+		exit(1);
+	}
+
+	if (!n) {
+		fprintf(stderr, "Error: No SMBus adapter found\n");
+		exit(1);
+	}
+
+	if (!yes) {
+		fprintf(stderr, "WARNING! This program can confuse your I2C "
+			"bus, cause data loss and worse!\n");
+		fprintf(stderr, "I will read addresses 0x%02x-0x%02x on %d "
+			"bus%s:", SPD_FIRST, SPD_LAST, n, n > 1 ? "ses" : "");
+		for (i = 0; i < n; i++)
+			fprintf(stderr, " %d", workers[i].i2cbus);
+		fprintf(stderr, "\nContinue? [Y/n] ");
+		fflush(stderr);
+		if (!user_ack(1)) {
+			fprintf(stderr, "Aborting on user request.\n");
+			exit(0);
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i++) {
+		workers[i].force = force;
+		if (pthread_create(&workers[i].thread, NULL, worker_run,
+				   &workers[i])) {
+			fprintf(stderr, "Error: Could not start thread for "
+				"bus %d\n", workers[i].i2cbus);
+			workers[i].error = -EAGAIN;
+			continue;
+		}
+		workers[i].started = 1;
+	}
+	for (i = 0; i < n; i++)
+		if (workers[i].started)
+			pthread_join(workers[i].thread, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	/* Report in bus order, once all reads are done */
+	for (i = 0; i < n; i++) {
+		if (workers[i].error) {
+			errors++;
+			continue;
+		}
+		errors += workers[i].failed;
+		for (j = 0; j < SPD_COUNT; j++) {
+			if (!workers[i].images[j].len)
+				continue;
+			if (save_image(dir, workers[i].i2cbus,
+				       &workers[i].images[j]))
+				errors++;
+			else
+				found++;
+		}
+		fprintf(stderr, "Bus %d read in %lld ms\n", workers[i].i2cbus,
+			workers[i].ns / 1000000);
+	}
+	fprintf(stderr, "%d SPD EEPROM%s saved in %lld ms\n", found,
+		found == 1 ? "" : "s",
+		(timespec_ns(&end) - timespec_ns(&start)) / 1000000);
+
+	free(workers);
+	exit(errors ? 1 : 0);
+}
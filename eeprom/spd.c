@@ -0,0 +1,1833 @@
+/*
+    spd.c - Memory module Serial Presence Detect decoding
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    Based on decode-dimms:
+    Copyright 1998, 1999 Philip Edelbrock <phil@netroedge.com>
+    modified by Christian Zuckschwerdt <zany@triq.net>
+    modified by Burkart Lingner <burkart@bollchen.de>
+    Copyright (C) 2005-2013  Jean Delvare <jdelvare@suse.de>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "spd.h"
+#include "spd-vendors.h"
+
+/*
+ * Reading
+ */
+
+int spd_used_size(const unsigned char *bytes)
+{
+	int used;
+
+	if (bytes[2] >= 9) {
+		/* For FB-DIMM and newer, decode number of bytes written */
+		switch ((bytes[0] >> 4) & 7) {
+		case 0: used = 128; break;
+		case 1: used = 176; break;
+		case 2: used = 256; break;
+		default: used = 64;
+		}
+	} else {
+		used = bytes[0] < 64 ? 64 : bytes[0];
+	}
+
+	/* The first 128 bytes are always decoded */
+	if (used < 128)
+		used = 128;
+	return used > SPD_MAX_SIZE ? SPD_MAX_SIZE : used;
+}
+
+static int read_full(int fd, unsigned char *buf, int offset, int len)
+{
+	ssize_t got;
+	int done = 0;
+
+	while (done < len) {
+		got = pread(fd, buf + done, len - done, offset + done);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got < 0)
+			return -errno;
+		if (got == 0)
+			break;
+		done += got;
+	}
+
+	return done;
+}
+
+int spd_read(const char *path, unsigned char *bytes, int size)
+{
+	char eeprom[PATH_MAX];
+	struct stat st;
+	int fd, len, used, res;
+
+	if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+		if (snprintf(eeprom, sizeof(eeprom), "%s/eeprom", path)
+		    >= (int)sizeof(eeprom))
+			return -ENAMETOOLONG;
+		path = eeprom;
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	/*
+	 * Reading an EEPROM through sysfs is slow, so read what we know we
+	 * need first, and only then what the SPD data says is used.
+	 */
+	len = read_full(fd, bytes, 0, size < 128 ? size : 128);
+	if (len == 128) {
+		used = spd_used_size(bytes);
+		if (used > size)
+			used = size;
+		if (used > len) {
+			res = read_full(fd, bytes + len, len, used - len);
+			len = res < 0 ? res : len + res;
+		}
+	}
+	close(fd);
+
+	if (len >= 0 && len < 128)
+		return -EIO;
+	return len;
+}
+
+/*
+ * Output helpers
+ */
+
+static void add_field(struct spd_decoded *spd, const char *label,
+		      const char *value)
+{
+	struct spd_field *field;
+
+	if (spd->nfields == spd->max_fields) {
+		int max = spd->max_fields ? 2 * spd->max_fields : 64;
+
+		field = realloc(spd->fields, max * sizeof(*field));
+		if (!field) {
+			spd->error = -ENOMEM;
+			return;
+		}
+		spd->fields = field;
+		spd->max_fields = max;
+	}
+
+	field = &spd->fields[spd->nfields];
+	field->label = strdup(label);
+	field->value = value ? strdup(value) : NULL;
+	if (!field->label || (value && !field->value)) {
+		free(field->label);
+		free(field->value);
+		spd->error = -ENOMEM;
+		return;
+	}
+	spd->nfields++;
+}
+
+static void prints(struct spd_decoded *spd, const char *section)
+{
+	add_field(spd, section, NULL);
+}
+
+static void printl(struct spd_decoded *spd, const char *label,
+		   const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
+
+static void printl(struct spd_decoded *spd, const char *label,
+		   const char *fmt, ...)
+{
+	char value[512];
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(value, sizeof(value), fmt, ap);
+	va_end(ap);
+	add_field(spd, label, value);
+}
+
+/* Values built piece by piece, such as multi-line ones */
+struct strbuf {
+	char s[512];
+	int len;
+};
+
+static void sb_add(struct strbuf *sb, const char *fmt, ...)
+	__attribute__ ((format (printf, 2, 3)));
+
+static void sb_add(struct strbuf *sb, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	if (sb->len >= (int)sizeof(sb->s) - 1)
+		return;
+	va_start(ap, fmt);
+	n = vsnprintf(sb->s + sb->len, sizeof(sb->s) - sb->len, fmt, ap);
+	va_end(ap);
+	if (n > 0)
+		sb->len += n;
+	if (sb->len > (int)sizeof(sb->s) - 1)
+		sb->len = sizeof(sb->s) - 1;
+}
+
+/* Drop the trailing newline of flag lists */
+static const char *sb_str(struct strbuf *sb)
+{
+	if (sb->len && sb->s[sb->len - 1] == '\n')
+		sb->s[--sb->len] = '\0';
+	return sb->s;
+}
+
+/*
+ * Helper functions
+ */
+
+/*
+ * We consider that no data was written to this area of the SPD EEPROM if
+ * all bytes read 0x00 or all bytes read 0xff
+ */
+static int spd_written(const unsigned char *bytes, int len)
+{
+	int i, all_00 = 1, all_ff = 1;
+
+	for (i = 0; i < len; i++) {
+		if (bytes[i] != 0x00)
+			all_00 = 0;
+		if (bytes[i] != 0xff)
+			all_ff = 0;
+		if (!all_00 && !all_ff)
+			return 1;
+	}
+
+	return 0;
+}
+
+static int parity(int n)
+{
+	int p = 0;
+
+	while (n) {
+		p += n & 1;
+		n >>= 1;
+	}
+
+	return p & 1;
+}
+
+/* The code byte includes parity, the count byte does not */
+static const char *manufacturer_common(int count, int code)
+{
+	if (parity(code) != 1 || (code &= 0x7f) == 0)
+		return "Invalid";
+	if (count >= (int)(sizeof(spd_vendors) / sizeof(spd_vendors[0]))
+	 || code - 1 >= spd_vendors[count].count)
+		return "Unknown";
+	return spd_vendors[count].names[code - 1];
+}
+
+/*
+ * New encoding format (as of DDR3) for manufacturer just has a count of
+ * leading 0x7F rather than all the individual bytes. The count byte
+ * includes parity!
+ */
+static const char *manufacturer_ddr3(int count, int code, char *buf,
+				     size_t size)
+{
+	unsigned char b[2] = { count, code };
+
+	if (!spd_written(b, 2))
+		return "Undefined";
+
+	snprintf(buf, size, "%s%s", manufacturer_common(count & 0x7f, code),
+		 parity(count) != 1 ? "? (Invalid parity)" : "");
+	return buf;
+}
+
+static const char *part_number(const unsigned char *bytes, int len,
+			       char *buf)
+{
+	int i;
+
+	for (i = 0; i < len && bytes[i] >= 32 && bytes[i] < 127; i++)
+		buf[i] = bytes[i];
+	buf[i] = '\0';
+
+	return i ? buf : "Undefined";
+}
+
+/* Latencies are given in half cycles, to cope with DDR */
+static const char *cas_latencies(const int *cas2, int n, char *buf,
+				 size_t size)
+{
+	struct strbuf sb = { "", 0 };
+	int i;
+
+	if (!n)
+		return "None";
+
+	for (i = n - 1; i >= 0; i--)
+		sb_add(&sb, "%s%gT", i == n - 1 ? "" : ", ", cas2[i] / 2.0);
+	snprintf(buf, size, "%s", sb.s);
+	return buf;
+}
+
+static const char *tns1(double t, char *buf, size_t size)
+{
+	snprintf(buf, size, "%.1f ns", t);
+	return buf;
+}
+
+static const char *tns(double t, char *buf, size_t size)
+{
+	snprintf(buf, size, "%3.2f ns", t);
+	return buf;
+}
+
+static const char *tns3(double t, char *buf, size_t size)
+{
+	snprintf(buf, size, "%.3f ns", t);
+	return buf;
+}
+
+static const char *value_or_undefined(int value, const char *unit,
+				      char *buf, size_t size)
+{
+	if (!value)
+		return "Undefined!";
+	snprintf(buf, size, "%d%s%s", value, unit ? " " : "",
+		 unit ? unit : "");
+	return buf;
+}
+
+/* Common to SDR, DDR and DDR2 SDRAM */
+static const char *sdram_voltage_interface_level(int byte)
+{
+	static const char *const levels[] = {
+		"TTL (5V tolerant)",		/*  0 */
+		"LVTTL (not 5V tolerant)",	/*  1 */
+		"HSTL 1.5V",			/*  2 */
+		"SSTL 3.3V",			/*  3 */
+		"SSTL 2.5V",			/*  4 */
+		"SSTL 1.8V",			/*  5 */
+	};
+
+	return byte < 6 ? levels[byte] : "Undefined!";
+}
+
+/* Common to SDR, DDR and DDR2 SDRAM */
+static const char *sdram_module_configuration_type(int byte, char *buf,
+						   size_t size)
+{
+	struct strbuf sb = { "", 0 };
+
+	byte &= 0x07;
+	if (byte == 0)
+		return "No Parity";
+
+	/* Data ECC includes Data Parity so don't print both */
+	if ((byte & 0x03) == 0x01)
+		sb_add(&sb, "Data Parity");
+	if (byte & 0x02)
+		sb_add(&sb, "%sData ECC", sb.len ? ", " : "");
+	/* New in DDR2 specification */
+	if (byte & 0x04)
+		sb_add(&sb, "%sAddress/Command Parity", sb.len ? ", " : "");
+
+	snprintf(buf, size, "%s", sb.s);
+	return buf;
+}
+
+/* Common to SDR, DDR and DDR2 SDRAM */
+static const char *ddr2_refresh_rate(int byte, char *buf, size_t size)
+{
+	static const char *const refresh[] = {
+		"Normal", "Reduced", "Reduced",
+		"Extended", "Extended", "Extended",
+	};
+	static const double refresht[] = {
+		15.625, 3.9, 7.8, 31.3, 62.5, 125,
+	};
+	int rate = byte & 0x7f;
+
+	if (rate >= 6)
+		return "Undefined!";
+	snprintf(buf, size, "%s (%g us)%s", refresh[rate], refresht[rate],
+		 byte & 0x80 ? " - Self Refresh" : "");
+	return buf;
+}
+
+static const char *as_ddr(int gen, double ctime, char *buf, size_t size)
+{
+	if (gen == 1)
+		snprintf(buf, size, " as DDR-%d", (int)(2000 / ctime));
+	else
+		snprintf(buf, size, " as DDR%d-%d", gen, (int)(2000 / ctime));
+	return buf;
+}
+
+static const char *ddr_core_timings(double cas, double ctime, double trcd,
+				    double trp, double tras, char *buf,
+				    size_t size)
+{
+	snprintf(buf, size, "%g-%g-%g-%g", cas, ceil(trcd / ctime),
+		 ceil(trp / ctime), ceil(tras / ctime));
+	return buf;
+}
+
+static void list_bits(struct strbuf *sb, int byte, int nbits)
+{
+	int i;
+
+	for (i = 0; i < nbits; i++)
+		if (byte & (1 << i))
+			sb_add(sb, "%s%d", sb->len ? ", " : "", i);
+	if (!sb->len)
+		sb_add(sb, "None");
+}
+
+/* Signed setup and hold times of SDR SDRAM */
+static void sdr_signal_time(struct spd_decoded *spd, const char *label,
+			    int byte)
+{
+	double t = ((byte & 0x7f) >> 4) + (byte & 0xf) * 0.1;
+
+	if ((byte & 0xf) <= 9)
+		printl(spd, label, "%g ns", byte >> 7 ? -t : t);
+}
+
+/*
+ * SDR SDRAM
+ * Parameter: EEPROM bytes 0-127 (using 3-62)
+ */
+static void decode_sdr_sdram(struct spd_decoded *spd, const unsigned char *b)
+{
+	char t1[64];
+	struct strbuf sb;
+	int cas[7], ncas = 0, cas2[7];
+	double ctime, ctime_min, ctime1 = 0, ctime2 = 0, trcd, trp, tras;
+	static const double speeds[] = { 7.5, 10, 15 };
+	int i, k = 0, ii;
+
+	/* Starting with SPD revision 1.2, this byte is encoded in BCD */
+	if (b[62] < 0x12)
+		printl(spd, "SPD Revision", "%d", b[62]);
+	else
+		printl(spd, "SPD Revision", "%d.%d", b[62] >> 4, b[62] & 0xf);
+
+	/* size computation */
+	prints(spd, "Memory Characteristics");
+
+	ii = (b[3] & 0x0f) + (b[4] & 0x0f) - 17;
+	if (b[5] <= 8 && b[17] <= 8)
+		k = b[5] * b[17];
+	if (ii > 0 && ii <= 12 && k > 0)
+		printl(spd, "Size", "%d MB", (1 << ii) * k);
+	else
+		printl(spd, "Size", "INVALID: %d,%d,%d,%d", b[3], b[4], b[5],
+		       b[17]);
+
+	for (i = 0; i < 7; i++) {
+		if (b[18] & (1 << i)) {
+			cas2[ncas] = 2 * (i + 1);
+			cas[ncas++] = i + 1;
+		}
+	}
+
+	ctime_min = ctime = (b[9] >> 4) + (b[9] & 0xf) * 0.1;
+	trcd = b[29];
+	trp = b[27];
+	tras = b[30];
+
+	if (ncas)
+		printl(spd, "tCL-tRCD-tRP-tRAS", "%s",
+		       ddr_core_timings(cas[ncas - 1], ctime, trcd, trp, tras,
+					t1, sizeof(t1)));
+
+	for (i = 3; i <= 4; i++) {
+		const char *label = i == 3 ? "Number of Row Address Bits" :
+				    "Number of Col Address Bits";
+
+		if (b[i] == 0)
+			printl(spd, label, "Undefined!");
+		else if (b[i] <= 3)
+			printl(spd, label, "%d/%d", b[i], b[i] + 15);
+		else
+			printl(spd, label, "%d", b[i]);
+	}
+
+	printl(spd, "Number of Module Rows", "%s",
+	       value_or_undefined(b[5], NULL, t1, sizeof(t1)));
+
+	if (b[7] > 1)
+		printl(spd, "Data Width", "Undefined!");
+	else
+		printl(spd, "Data Width", "%d", b[7] * 256 + b[6]);
+
+	printl(spd, "Voltage Interface Level", "%s",
+	       sdram_voltage_interface_level(b[8]));
+	printl(spd, "Module Configuration Type", "%s",
+	       sdram_module_configuration_type(b[11], t1, sizeof(t1)));
+	printl(spd, "Refresh Rate", "%s",
+	       ddr2_refresh_rate(b[12], t1, sizeof(t1)));
+
+	printl(spd, "Primary SDRAM Component Bank Config", "%s",
+	       b[13] & 0x80 ? "Bank2 = 2 x Bank1" :
+	       "No Bank2 OR Bank2 = Bank1 width");
+	printl(spd, "Primary SDRAM Component Widths", "%s",
+	       value_or_undefined(b[13] & 0x7f, NULL, t1, sizeof(t1)));
+	printl(spd, "Error Checking SDRAM Component Bank Config", "%s",
+	       b[14] & 0x80 ? "Bank2 = 2 x Bank1" :
+	       "No Bank2 OR Bank2 = Bank1 width");
+	printl(spd, "Error Checking SDRAM Component Widths", "%s",
+	       value_or_undefined(b[14] & 0x7f, NULL, t1, sizeof(t1)));
+	printl(spd, "Min Clock Delay for Back to Back Random Access", "%s",
+	       value_or_undefined(b[15], NULL, t1, sizeof(t1)));
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	for (i = 0; i < 4; i++)
+		if (b[16] & (1 << i))
+			sb_add(&sb, "%s%d", sb.len ? ", " : "", 1 << i);
+	if (b[16] & 128)
+		sb_add(&sb, "%sPage", sb.len ? ", " : "");
+	printl(spd, "Supported Burst Lengths", "%s", sb.len ? sb.s : "None");
+
+	printl(spd, "Number of Device Banks", "%s",
+	       value_or_undefined(b[17], NULL, t1, sizeof(t1)));
+
+	printl(spd, "Supported CAS Latencies", "%s",
+	       cas_latencies(cas2, ncas, t1, sizeof(t1)));
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	list_bits(&sb, b[19], 7);
+	printl(spd, "Supported CS Latencies", "%s", sb.s);
+	sb.len = 0;
+	sb.s[0] = '\0';
+	list_bits(&sb, b[20], 7);
+	printl(spd, "Supported WE Latencies", "%s", sb.s);
+
+	if (ncas >= 1) {
+		struct strbuf cycle = { "", 0 }, access = { "", 0 };
+		int temp;
+
+		sb_add(&cycle, "%g ns at CAS %d", ctime, cas[ncas - 1]);
+		sb_add(&access, "%g ns at CAS %d",
+		       (b[10] >> 4) + (b[10] & 0xf) * 0.1, cas[ncas - 1]);
+
+		if (ncas >= 2 && spd_written(b + 23, 2)) {
+			temp = b[23] >> 4;
+			if (temp == 0) {
+				sb_add(&cycle, "\nUndefined! ns at CAS %d",
+				       cas[ncas - 2]);
+			} else {
+				if (temp < 4)
+					temp += 15;
+				ctime1 = temp + (b[23] & 0xf) * 0.1;
+				sb_add(&cycle, "\n%g ns at CAS %d", ctime1,
+				       cas[ncas - 2]);
+			}
+
+			temp = b[24] >> 4;
+			if (temp == 0) {
+				sb_add(&access, "\nUndefined! ns at CAS %d",
+				       cas[ncas - 2]);
+			} else {
+				if (temp < 4)
+					temp += 15;
+				sb_add(&access, "\n%g ns at CAS %d",
+				       temp + (b[24] & 0xf) * 0.1,
+				       cas[ncas - 2]);
+			}
+		}
+
+		if (ncas >= 3 && spd_written(b + 25, 2)) {
+			temp = b[25] >> 2;
+			if (temp == 0) {
+				sb_add(&cycle, "\nUndefined! ns at CAS %d",
+				       cas[ncas - 3]);
+			} else {
+				ctime2 = temp + (b[25] & 0x3) * 0.25;
+				sb_add(&cycle, "\n%g ns at CAS %d", ctime2,
+				       cas[ncas - 3]);
+			}
+
+			temp = b[26] >> 2;
+			if (temp == 0)
+				sb_add(&access, "\nUndefined! ns at CAS %d",
+				       cas[ncas - 3]);
+			else
+				sb_add(&access, "\n%g ns at CAS %d",
+				       temp + (b[26] & 0x3) * 0.25,
+				       cas[ncas - 3]);
+		}
+
+		printl(spd, "Cycle Time", "%s", cycle.s);
+		printl(spd, "Access Time", "%s", access.s);
+	}
+
+	prints(spd, "Attributes");
+	if (b[21]) {
+		static const char *const attrs[] = {
+			"Buffered Address/Control Inputs",
+			"Registered Address/Control Inputs",
+			"On card PLL (clock)",
+			"Buffered DQMB Inputs",
+			"Registered DQMB Inputs",
+			"Differential Clock Input",
+			"Redundant Row Address",
+			"Undefined (bit 7)",
+		};
+
+		sb.len = 0;
+		sb.s[0] = '\0';
+		for (i = 0; i < 8; i++)
+			if (b[21] & (1 << i))
+				sb_add(&sb, "%s\n", attrs[i]);
+		printl(spd, "SDRAM Module Attributes", "%s", sb_str(&sb));
+	}
+
+	/* standard SDR speeds */
+	prints(spd, "Timings at Standard Speeds");
+	for (i = 0; i < 3 && ncas; i++) {
+		double ct = speeds[i];
+		int best_cas;
+		char label[96];
+
+		/* Find min CAS latency at this speed */
+		if (ctime2 && ct >= ctime2 && ncas >= 3)
+			best_cas = cas[ncas - 3];
+		else if (ctime1 && ct >= ctime1 && ncas >= 2)
+			best_cas = cas[ncas - 2];
+		else
+			best_cas = cas[ncas - 1];
+
+		if (ct < ctime_min)
+			continue;
+		snprintf(label, sizeof(label), "tCL-tRCD-tRP-tRAS as PC%d",
+			 (int)(1000 / ct));
+		printl(spd, label, "%s", ddr_core_timings(best_cas, ct, trcd,
+							 trp, tras, t1,
+							 sizeof(t1)));
+	}
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	if (b[22] & 1)
+		sb_add(&sb, "Supports Early RAS# Recharge\n");
+	if (b[22] & 2)
+		sb_add(&sb, "Supports Auto-Precharge\n");
+	if (b[22] & 4)
+		sb_add(&sb, "Supports Precharge All\n");
+	if (b[22] & 8)
+		sb_add(&sb, "Supports Write1/Read Burst\n");
+	sb_add(&sb, "Lower VCC Tolerance: %s\n", b[22] & 16 ? "5%" : "10%");
+	sb_add(&sb, "Upper VCC Tolerance: %s\n", b[22] & 32 ? "5%" : "10%");
+	if (b[22] & 64)
+		sb_add(&sb, "Undefined (bit 6)\n");
+	if (b[22] & 128)
+		sb_add(&sb, "Undefined (bit 7)\n");
+	printl(spd, "SDRAM Device Attributes (General)", "%s", sb_str(&sb));
+
+	prints(spd, "Timing Parameters");
+	printl(spd, "Minimum Row Precharge Time", "%s",
+	       value_or_undefined(b[27], "ns", t1, sizeof(t1)));
+	printl(spd, "Row Active to Row Active Min", "%s",
+	       value_or_undefined(b[28], "ns", t1, sizeof(t1)));
+	printl(spd, "RAS to CAS Delay", "%s",
+	       value_or_undefined(b[29], "ns", t1, sizeof(t1)));
+	printl(spd, "Min RAS Pulse Width", "%s",
+	       value_or_undefined(b[30], "ns", t1, sizeof(t1)));
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	for (i = 0; i < 8; i++)
+		if (b[31] & (1 << i))
+			sb_add(&sb, "%d MByte\n", 4 << i);
+	if (b[31] == 0)
+		sb_add(&sb, "(Undefined! -- None Reported!)\n");
+	printl(spd, "Row Densities", "%s", sb_str(&sb));
+
+	sdr_signal_time(spd, "Command and Address Signal Setup Time", b[32]);
+	sdr_signal_time(spd, "Command and Address Signal Hold Time", b[33]);
+	sdr_signal_time(spd, "Data Signal Setup Time", b[34]);
+	sdr_signal_time(spd, "Data Signal Hold Time", b[35]);
+}
+
+static double ddr2_sdram_atime(int byte)
+{
+	return (byte >> 4) * 0.1 + (byte & 0xf) * 0.01;
+}
+
+/*
+ * Cycle times of DDR SDRAM are given in ns (high nibble) and tenths of
+ * ns (low nibble), latencies in half cycles from CAS 1 (bit 0) up.
+ */
+static void decode_ddr_sdram(struct spd_decoded *spd, const unsigned char *b)
+{
+	char t1[64], t2[64];
+	struct strbuf sb, core = { "", 0 }, cycle = { "", 0 },
+		      access = { "", 0 };
+	double ctime, ctime1 = 0, ctime2 = 0, ctime_min, ctime_max;
+	double ddrclk, trcd, trp, tras;
+	static const double speeds[] = { 5, 6, 7.5, 10 };
+	int i, ii, k = 0, tbits, pcclk, highest = 0, cas_sup = 0;
+	int cas2[7], ncas = 0;
+
+	if (b[62] != 0xff)
+		printl(spd, "SPD Revision", "%d.%d", b[62] >> 4, b[62] & 0xf);
+
+	/* speed */
+	prints(spd, "Memory Characteristics");
+
+	ctime_min = ctime = (b[9] >> 4) + (b[9] & 0xf) * 0.1;
+	ddrclk = 2 * (1000 / ctime);
+	tbits = b[7] * 256 + b[6];
+	if (b[11] == 2 || b[11] == 1)
+		tbits -= 8;
+	pcclk = (int)(ddrclk * tbits / 8);
+	if (pcclk % 100 >= 50)	/* Round properly */
+		pcclk += 100;
+	pcclk -= pcclk % 100;
+	printl(spd, "Maximum module speed", "%d MHz (PC%d)", (int)ddrclk,
+	       pcclk);
+
+	/* size computation */
+	ii = (b[3] & 0x0f) + (b[4] & 0x0f) - 17;
+	if (b[5] <= 8 && b[17] <= 8)
+		k = b[5] * b[17];
+	if (ii > 0 && ii <= 12 && k > 0)
+		printl(spd, "Size", "%d MB", (1 << ii) * k);
+	else
+		printl(spd, "Size", "INVALID: %d, %d, %d, %d", b[3], b[4],
+		       b[5], b[17]);
+
+	printl(spd, "Banks x Rows x Columns x Bits", "%d x %d x %d x %d",
+	       b[17], b[3], b[4], b[6]);
+	printl(spd, "Ranks", "%d", b[5]);
+
+	printl(spd, "Voltage Interface Level", "%s",
+	       sdram_voltage_interface_level(b[8]));
+	printl(spd, "Module Configuration Type", "%s",
+	       sdram_module_configuration_type(b[11], t1, sizeof(t1)));
+	printl(spd, "Refresh Rate", "%s",
+	       ddr2_refresh_rate(b[12], t1, sizeof(t1)));
+
+	/* CAS latencies in half cycles: bit 0 is CAS 1 */
+	for (i = 0; i < 7; i++) {
+		if (b[18] & (1 << i)) {
+			highest = 2 + i;
+			cas2[ncas++] = highest;
+			cas_sup |= 1 << highest;
+		}
+	}
+
+	trcd = (b[29] >> 2) + (b[29] & 3) * 0.25;
+	trp = (b[27] >> 2) + (b[27] & 3) * 0.25;
+	tras = b[30];
+
+	/* latencies */
+	printl(spd, "Supported CAS Latencies", "%s",
+	       cas_latencies(cas2, ncas, t1, sizeof(t1)));
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	list_bits(&sb, b[19], 7);
+	printl(spd, "Supported CS Latencies", "%s", sb.s);
+	sb.len = 0;
+	sb.s[0] = '\0';
+	list_bits(&sb, b[20], 7);
+	printl(spd, "Supported WE Latencies", "%s", sb.s);
+
+	/* timings */
+	if (highest) {
+		sb_add(&core, "%s%s", ddr_core_timings(highest / 2.0, ctime,
+						       trcd, trp, tras, t1,
+						       sizeof(t1)),
+		       as_ddr(1, ctime, t2, sizeof(t2)));
+		sb_add(&cycle, "%g ns at CAS %g", ctime, highest / 2.0);
+		sb_add(&access, "%g ns at CAS %g", ddr2_sdram_atime(b[10]),
+		       highest / 2.0);
+	}
+
+	if (highest >= 1 && (cas_sup & (1 << (highest - 1)))
+	 && spd_written(b + 23, 2)) {
+		ctime1 = (b[23] >> 4) + (b[23] & 0xf) * 0.1;
+		sb_add(&core, "\n%s%s",
+		       ddr_core_timings((highest - 1) / 2.0, ctime1, trcd, trp,
+					tras, t1, sizeof(t1)),
+		       as_ddr(1, ctime1, t2, sizeof(t2)));
+		sb_add(&cycle, "\n%g ns at CAS %g", ctime1,
+		       (highest - 1) / 2.0);
+		sb_add(&access, "\n%g ns at CAS %g", ddr2_sdram_atime(b[24]),
+		       (highest - 1) / 2.0);
+	}
+
+	if (highest >= 2 && (cas_sup & (1 << (highest - 2)))
+	 && spd_written(b + 25, 2)) {
+		ctime2 = (b[25] >> 4) + (b[25] & 0xf) * 0.1;
+		sb_add(&core, "\n%s%s",
+		       ddr_core_timings((highest - 2) / 2.0, ctime2, trcd, trp,
+					tras, t1, sizeof(t1)),
+		       as_ddr(1, ctime2, t2, sizeof(t2)));
+		sb_add(&cycle, "\n%g ns at CAS %g", ctime2,
+		       (highest - 2) / 2.0);
+		sb_add(&access, "\n%g ns at CAS %g", ddr2_sdram_atime(b[26]),
+		       (highest - 2) / 2.0);
+	}
+
+	ctime_max = b[43] == 0xff ? 0 : b[43] / 4.0;
+
+	if (highest) {
+		printl(spd, "tCL-tRCD-tRP-tRAS", "%s", core.s);
+		printl(spd, "Minimum Cycle Time", "%s", cycle.s);
+		printl(spd, "Maximum Access Time", "%s", access.s);
+	}
+	if (b[43] & 0xfc) {
+		if (b[43] == 0xff)
+			printl(spd, "Maximum Cycle Time (tCK max)",
+			       "No minimum frequency");
+		else
+			printl(spd, "Maximum Cycle Time (tCK max)",
+			       "%s (DDR-%d)", tns1(ctime_max, t1, sizeof(t1)),
+			       8000 / b[43]);
+	}
+
+	/* standard DDR speeds */
+	prints(spd, "Timings at Standard Speeds");
+	for (i = 0; i < 4 && highest; i++) {
+		double ct = speeds[i];
+		double best_cas;
+		char label[96];
+
+		/* Find min CAS latency at this speed */
+		if (ctime2 && ct >= ctime2)
+			best_cas = (highest - 2) / 2.0;
+		else if (ctime1 && ct >= ctime1)
+			best_cas = (highest - 1) / 2.0;
+		else
+			best_cas = highest / 2.0;
+
+		if (ct < ctime_min || (ctime_max >= 1 && ct > ctime_max))
+			continue;
+		snprintf(label, sizeof(label), "tCL-tRCD-tRP-tRAS%s",
+			 as_ddr(1, ct, t2, sizeof(t2)));
+		printl(spd, label, "%s", ddr_core_timings(best_cas, ct, trcd,
+							 trp, tras, t1,
+							 sizeof(t1)));
+	}
+
+	/* more timing information */
+	prints(spd, "Timing Parameters");
+	if (b[32] != 0xff)
+		printl(spd, "Address/Command Setup Time Before Clock", "%s",
+		       tns(ddr2_sdram_atime(b[32]), t1, sizeof(t1)));
+	if (b[33] != 0xff)
+		printl(spd, "Address/Command Hold Time After Clock", "%s",
+		       tns(ddr2_sdram_atime(b[33]), t1, sizeof(t1)));
+	if (b[34] != 0xff)
+		printl(spd, "Data Input Setup Time Before Clock", "%s",
+		       tns(ddr2_sdram_atime(b[34]), t1, sizeof(t1)));
+	if (b[35] != 0xff)
+		printl(spd, "Data Input Hold Time After Clock", "%s",
+		       tns(ddr2_sdram_atime(b[35]), t1, sizeof(t1)));
+	printl(spd, "Minimum Row Precharge Delay (tRP)", "%s",
+	       tns(trp, t1, sizeof(t1)));
+	if (b[28] & 0xfc)
+		printl(spd, "Minimum Row Active to Row Active Delay (tRRD)",
+		       "%s", tns(b[28] / 4.0, t1, sizeof(t1)));
+	printl(spd, "Minimum RAS# to CAS# Delay (tRCD)", "%s",
+	       tns(trcd, t1, sizeof(t1)));
+	printl(spd, "Minimum RAS# Pulse Width (tRAS)", "%s",
+	       tns(tras, t1, sizeof(t1)));
+	if (b[41] && b[41] != 0xff)
+		printl(spd, "Minimum Active to Active/AR Time (tRC)", "%s",
+		       tns(b[41], t1, sizeof(t1)));
+	if (b[42])
+		printl(spd, "Minimum AR to Active/AR Command Period (tRFC)",
+		       "%s", tns(b[42], t1, sizeof(t1)));
+	if (b[44])
+		printl(spd, "Maximum DQS to DQ Skew (tDQSQ)", "%s",
+		       tns(b[44] / 100.0, t1, sizeof(t1)));
+	if ((b[45] & 0xf0) && b[45] != 0xff)
+		printl(spd, "Maximum Read Data Hold Skew (tQHS)", "%s",
+		       tns(ddr2_sdram_atime(b[45]), t1, sizeof(t1)));
+
+	/* module attributes */
+	prints(spd, "Module Attributes");
+	if (b[47] & 0x03)
+		printl(spd, "Module Height", "%s",
+		       (b[47] & 0x03) == 0x01 ? "1.125\" to 1.25\"" :
+		       (b[47] & 0x03) == 0x02 ? "1.7\"" : "Other");
+}
+
+static double ddr2_sdram_ctime(int byte)
+{
+	double ctime = byte >> 4;
+
+	switch (byte & 0xf) {
+	case 10: ctime += 0.25; break;
+	case 11: ctime += 0.33; break;
+	case 12: ctime += 0.66; break;
+	case 13: ctime += 0.75; break;
+	default:
+		if ((byte & 0xf) <= 9)
+			ctime += (byte & 0xf) * 0.1;
+	}
+
+	return ctime;
+}
+
+/* Base, high-bit, 3-bit fraction code */
+static double ddr2_sdram_rtime(int rtime, int msb, int ext)
+{
+	static const double table[] = { 0, .25, .33, .50, .66, .75, 0, 0 };
+
+	return rtime + msb * 256 + table[ext & 7];
+}
+
+static void decode_ddr2_sdram(struct spd_decoded *spd, const unsigned char *b)
+{
+	char t1[64], t2[64];
+	struct strbuf sb, core = { "", 0 }, cycle = { "", 0 },
+		      access = { "", 0 };
+	double ctime, ctime1 = 0, ctime2 = 0, ctime_min, ctime_max;
+	double ddrclk, trcd, trp, tras;
+	static const double speeds[] = { 1.875, 2.5, 3, 3.75, 5 };
+	static const char *const heights[] = {
+		"< 25.4", "25.4", "25.4 - 30.0", "30.0", "30.5", "> 30.5",
+		"> 30.5", "> 30.5",
+	};
+	static const char *const types[] = {
+		"RDIMM", "UDIMM", "SO-DIMM", "Micro-DIMM", "Mini-RDIMM",
+		"Mini-UDIMM",
+	};
+	static const char *const widths[] = {
+		"133.35", "133.25", "67.6", "45.5", "82", "82",
+	};
+	int i, ii, k, tbits, pcclk, highest = 0, cas_sup = 0, ntypes = 0;
+	int cas2[7], ncas = 0;
+
+	if (b[62] != 0xff)
+		printl(spd, "SPD Revision", "%d.%d", b[62] >> 4, b[62] & 0xf);
+
+	/* speed */
+	prints(spd, "Memory Characteristics");
+
+	ctime_min = ctime = ddr2_sdram_ctime(b[9]);
+	ddrclk = 2 * (1000 / ctime);
+	tbits = b[7] * 256 + b[6];
+	if (b[11] & 0x03)
+		tbits -= 8;
+	pcclk = (int)(ddrclk * tbits / 8);
+	/* Round down to comply with Jedec */
+	pcclk -= pcclk % 100;
+	printl(spd, "Maximum module speed", "%d MHz (PC2-%d)", (int)ddrclk,
+	       pcclk);
+
+	/* size computation */
+	ii = (b[3] & 0x0f) + (b[4] & 0x0f) - 17;
+	k = ((b[5] & 0x7) + 1) * b[17];
+	if (ii > 0 && ii <= 12 && k > 0)
+		printl(spd, "Size", "%d MB", (1 << ii) * k);
+	else
+		printl(spd, "Size", "INVALID: %d,%d,%d,%d", b[3], b[4], b[5],
+		       b[17]);
+
+	printl(spd, "Banks x Rows x Columns x Bits", "%d x %d x %d x %d",
+	       b[17], b[3], b[4], b[6]);
+	printl(spd, "Ranks", "%d", (b[5] & 7) + 1);
+	printl(spd, "SDRAM Device Width", "%d bits", b[13]);
+	printl(spd, "Module Height", "%s mm", heights[b[5] >> 5]);
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	for (i = 0; i < 6; i++) {
+		if (b[20] & (1 << i)) {
+			sb_add(&sb, "%s%s (%s mm)", sb.len ? ", " : "",
+			       types[i], widths[i]);
+			ntypes++;
+		}
+	}
+	printl(spd, ntypes > 1 ? "Module Types" : "Module Type", "%s", sb.s);
+
+	printl(spd, "DRAM Package", "%s", b[5] & 0x10 ? "Stack" : "Planar");
+	printl(spd, "Voltage Interface Level", "%s",
+	       sdram_voltage_interface_level(b[8]));
+	printl(spd, "Module Configuration Type", "%s",
+	       sdram_module_configuration_type(b[11], t1, sizeof(t1)));
+	printl(spd, "Refresh Rate", "%s",
+	       ddr2_refresh_rate(b[12], t1, sizeof(t1)));
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	if (b[16] & 4)
+		sb_add(&sb, "4");
+	if (b[16] & 8)
+		sb_add(&sb, "%s8", sb.len ? ", " : "");
+	printl(spd, "Supported Burst Lengths", "%s", sb.len ? sb.s : "None");
+
+	for (i = 2; i < 7; i++) {
+		if (b[18] & (1 << i)) {
+			highest = i;
+			cas2[ncas++] = 2 * i;
+			cas_sup |= 1 << i;
+		}
+	}
+
+	trcd = (b[29] >> 2) + (b[29] & 3) * 0.25;
+	trp = (b[27] >> 2) + (b[27] & 3) * 0.25;
+	tras = b[30];
+
+	/* latencies */
+	printl(spd, "Supported CAS Latencies (tCL)", "%s",
+	       cas_latencies(cas2, ncas, t1, sizeof(t1)));
+
+	/* timings */
+	if (highest) {
+		sb_add(&core, "%s%s", ddr_core_timings(highest, ctime, trcd,
+						       trp, tras, t1,
+						       sizeof(t1)),
+		       as_ddr(2, ctime, t2, sizeof(t2)));
+		sb_add(&cycle, "%s at CAS %d (tCK min)",
+		       tns(ctime, t1, sizeof(t1)), highest);
+		sb_add(&access, "%s at CAS %d (tAC)",
+		       tns(ddr2_sdram_atime(b[10]), t1, sizeof(t1)), highest);
+	}
+
+	if (highest >= 1 && (cas_sup & (1 << (highest - 1)))
+	 && spd_written(b + 23, 2)) {
+		ctime1 = ddr2_sdram_ctime(b[23]);
+		sb_add(&core, "\n%s%s",
+		       ddr_core_timings(highest - 1, ctime1, trcd, trp, tras,
+					t1, sizeof(t1)),
+		       as_ddr(2, ctime1, t2, sizeof(t2)));
+		sb_add(&cycle, "\n%s at CAS %d", tns(ctime1, t1, sizeof(t1)),
+		       highest - 1);
+		sb_add(&access, "\n%s at CAS %d",
+		       tns(ddr2_sdram_atime(b[24]), t1, sizeof(t1)),
+		       highest - 1);
+	}
+
+	if (highest >= 2 && (cas_sup & (1 << (highest - 2)))
+	 && spd_written(b + 25, 2)) {
+		ctime2 = ddr2_sdram_ctime(b[25]);
+		sb_add(&core, "\n%s%s",
+		       ddr_core_timings(highest - 2, ctime2, trcd, trp, tras,
+					t1, sizeof(t1)),
+		       as_ddr(2, ctime2, t2, sizeof(t2)));
+		sb_add(&cycle, "\n%s at CAS %d", tns(ctime2, t1, sizeof(t1)),
+		       highest - 2);
+		sb_add(&access, "\n%s at CAS %d",
+		       tns(ddr2_sdram_atime(b[26]), t1, sizeof(t1)),
+		       highest - 2);
+	}
+
+	ctime_max = ddr2_sdram_ctime(b[43]);
+
+	if (highest) {
+		printl(spd, "tCL-tRCD-tRP-tRAS", "%s", core.s);
+		printl(spd, "Minimum Cycle Time", "%s", cycle.s);
+		printl(spd, "Maximum Access Time", "%s", access.s);
+	}
+	if ((b[43] & 0xf0) && b[43] != 0xff && ctime_max != 0)
+		printl(spd, "Maximum Cycle Time (tCK max)", "%s (DDR2-%d)",
+		       tns(ctime_max, t1, sizeof(t1)),
+		       (int)(2000 / ctime_max));
+
+	/* standard DDR2 speeds */
+	prints(spd, "Timings at Standard Speeds");
+	for (i = 0; i < 5 && highest; i++) {
+		double ct = speeds[i];
+		int best_cas;
+		char label[96];
+
+		/* Find min CAS latency at this speed */
+		if (ctime2 && ct >= ctime2)
+			best_cas = highest - 2;
+		else if (ctime1 && ct >= ctime1)
+			best_cas = highest - 1;
+		else
+			best_cas = highest;
+
+		if (ct < ctime_min || ct > ctime_max)
+			continue;
+		snprintf(label, sizeof(label), "tCL-tRCD-tRP-tRAS%s",
+			 as_ddr(2, ct, t2, sizeof(t2)));
+		printl(spd, label, "%s", ddr_core_timings(best_cas, ct, trcd,
+							 trp, tras, t1,
+							 sizeof(t1)));
+	}
+
+	/*
+	 * More timing information. According to the JEDEC standard, the
+	 * four timings below can't be less than 0.1 ns, however we've seen
+	 * memory modules code such values so handle them properly.
+	 */
+	prints(spd, "Timing Parameters");
+	if (b[32] && b[32] != 0xff)
+		printl(spd, "Address/Command Setup Time Before Clock (tIS)",
+		       "%s", tns(ddr2_sdram_atime(b[32]), t1, sizeof(t1)));
+	if (b[33] && b[33] != 0xff)
+		printl(spd, "Address/Command Hold Time After Clock (tIH)",
+		       "%s", tns(ddr2_sdram_atime(b[33]), t1, sizeof(t1)));
+	if (b[34] && b[34] != 0xff)
+		printl(spd, "Data Input Setup Time Before Strobe (tDS)", "%s",
+		       tns(ddr2_sdram_atime(b[34]), t1, sizeof(t1)));
+	if (b[35] && b[35] != 0xff)
+		printl(spd, "Data Input Hold Time After Strobe (tDH)", "%s",
+		       tns(ddr2_sdram_atime(b[35]), t1, sizeof(t1)));
+
+	printl(spd, "Minimum Row Precharge Delay (tRP)", "%s",
+	       tns(trp, t1, sizeof(t1)));
+	if (b[28] & 0xfc)
+		printl(spd, "Minimum Row Active to Row Active Delay (tRRD)",
+		       "%s", tns(b[28] / 4.0, t1, sizeof(t1)));
+	printl(spd, "Minimum RAS# to CAS# Delay (tRCD)", "%s",
+	       tns(trcd, t1, sizeof(t1)));
+	printl(spd, "Minimum RAS# Pulse Width (tRAS)", "%s",
+	       tns(tras, t1, sizeof(t1)));
+	if (b[36] & 0xfc)
+		printl(spd, "Write Recovery Time (tWR)", "%s",
+		       tns(b[36] / 4.0, t1, sizeof(t1)));
+	if (b[37] & 0xfc)
+		printl(spd, "Minimum Write to Read CMD Delay (tWTR)", "%s",
+		       tns(b[37] / 4.0, t1, sizeof(t1)));
+	if (b[38] & 0xfc)
+		printl(spd, "Minimum Read to Pre-charge CMD Delay (tRTP)",
+		       "%s", tns(b[38] / 4.0, t1, sizeof(t1)));
+
+	if (b[41] && b[41] != 0xff)
+		printl(spd, "Minimum Active to Auto-refresh Delay (tRC)", "%s",
+		       tns(ddr2_sdram_rtime(b[41], 0, (b[40] >> 4) & 7),
+			   t1, sizeof(t1)));
+	if (b[42])
+		printl(spd, "Minimum Recovery Delay (tRFC)", "%s",
+		       tns(ddr2_sdram_rtime(b[42], b[40] & 1,
+					    (b[40] >> 1) & 7),
+			   t1, sizeof(t1)));
+
+	if (b[44])
+		printl(spd, "Maximum DQS to DQ Skew (tDQSQ)", "%s",
+		       tns(b[44] / 100.0, t1, sizeof(t1)));
+	if (b[45])
+		printl(spd, "Maximum Read Data Hold Skew (tQHS)", "%s",
+		       tns(b[45] / 100.0, t1, sizeof(t1)));
+	if (b[46])
+		printl(spd, "PLL Relock Time", "%d us", b[46]);
+}
+
+/* Return combined time in ns */
+static double ddr3_mtb_ftb(int byte1, int byte2, double mtb, double ftb)
+{
+	/* byte1 is unsigned in ns, but byte2 is signed in ps */
+	if (byte2 & 0x80)
+		byte2 -= 0x100;
+
+	return byte1 * mtb + byte2 * ftb / 1000;
+}
+
+static const char *ddr3_reference_card(int rrc, int ext, char *buf,
+				       size_t size)
+{
+	static const char alphabet[] = "ABCDEFGHJKLMNPRTUVWY";
+	int len = sizeof(alphabet) - 1;
+	int ref = rrc & 0x1f;
+	int revision = ext >> 5;
+
+	if (ref == 0x1f)
+		return "ZZ";
+	if (rrc & 0x80)
+		ref += 0x1f;
+	if (revision == 0)
+		revision = (rrc >> 5) & 0x03;
+
+	if (ref < len)
+		/* One letter reference card */
+		snprintf(buf, size, "%c revision %d", alphabet[ref], revision);
+	else
+		/* Two letter reference card */
+		snprintf(buf, size, "%c%c revision %d", alphabet[ref / len],
+			 alphabet[ref % len], revision);
+	return buf;
+}
+
+static const char *ddr3_revision_number(int byte, char *buf, size_t size)
+{
+	int h = byte >> 4;
+	int l = byte & 0x0f;
+
+	/* Decode as suggested by JEDEC Standard 21-C */
+	if (h == 0)
+		snprintf(buf, size, "%d", l);
+	else if (h < 0xa)
+		snprintf(buf, size, "%d.%d", h, l);
+	else
+		snprintf(buf, size, "%c%d", 'A' + h - 0xa, l);
+	return buf;
+}
+
+static const char *ddr3_device_type(int byte, char *buf, size_t size)
+{
+	static const char *const dies[] = {
+		"", "\nSingle die", "\n2 die", "\n4 die", "\n8 die", "", "", ""
+	};
+	static const char *const loads[] = {
+		"", "\nMulti load stack", "\nSingle load stack", ""
+	};
+
+	snprintf(buf, size, "%s%s%s",
+		 byte & 0x80 ? "Non-Standard" : "Standard Monolithic",
+		 dies[(byte >> 4) & 0x07], loads[(byte >> 2) & 0x03]);
+	return buf;
+}
+
+enum ddr3_family {
+	DDR3_UNDEFINED,
+	DDR3_UNBUFFERED,
+	DDR3_REGISTERED,
+	DDR3_CLOCKED,
+	DDR3_LOAD_REDUCED,
+};
+
+static const struct {
+	const char *type;
+	const char *width;
+	enum ddr3_family family;
+} ddr3_module_types[] = {
+	{ "Undefined",		"Unknown",	DDR3_UNDEFINED },
+	{ "RDIMM",		"133.35 mm",	DDR3_REGISTERED },
+	{ "UDIMM",		"133.35 mm",	DDR3_UNBUFFERED },
+	{ "SO-DIMM",		"67.6 mm",	DDR3_UNBUFFERED },
+	{ "Micro-DIMM",		"TBD",		DDR3_UNBUFFERED },
+	{ "Mini-RDIMM",		"82.0 mm",	DDR3_REGISTERED },
+	{ "Mini-UDIMM",		"82.0 mm",	DDR3_UNBUFFERED },
+	{ "Mini-CDIMM",		"67.6 mm",	DDR3_CLOCKED },
+	{ "72b-SO-UDIMM",	"67.6 mm",	DDR3_UNBUFFERED },
+	{ "72b-SO-RDIMM",	"67.6 mm",	DDR3_REGISTERED },
+	{ "72b-SO-CDIMM",	"67.6 mm",	DDR3_CLOCKED },
+	{ "LRDIMM",		"133.35 mm",	DDR3_LOAD_REDUCED },
+	{ "16b-SO-DIMM",	"67.6 mm",	DDR3_UNBUFFERED },
+	{ "32b-SO-DIMM",	"67.6 mm",	DDR3_UNBUFFERED },
+};
+
+#define DDR3_NR_MODULE_TYPES \
+	(int)(sizeof(ddr3_module_types) / sizeof(ddr3_module_types[0]))
+
+/* Parameter: EEPROM bytes 0-127 (using 3-76) */
+static void decode_ddr3_sdram(struct spd_decoded *spd, const unsigned char *b)
+{
+	char t1[64], t2[64];
+	double ftb, mtb, ctime, ddrclk, taa, trcd, trp, tras;
+	static const double speeds[] = {
+		7.5 / 8, 7.5 / 7, 1.25, 1.5, 1.875, 2.5
+	};
+	int i, ii, tbits, pcclk, cap, k, cas_sup, ncas = 0, cas2[15];
+	enum ddr3_family family = DDR3_UNDEFINED;
+	struct strbuf sb;
+
+	if (b[3] < DDR3_NR_MODULE_TYPES) {
+		printl(spd, "Module Type", "%s", ddr3_module_types[b[3]].type);
+		family = ddr3_module_types[b[3]].family;
+	} else {
+		printl(spd, "Module Type", "Reserved (0x%.2X)", b[3]);
+	}
+
+	/* time bases */
+	if ((b[9] & 0x0f) == 0 || b[11] == 0) {
+		fprintf(stderr, "Invalid time base divisor, can't decode\n");
+		return;
+	}
+	ftb = (double)(b[9] >> 4) / (b[9] & 0x0f);
+	mtb = (double)b[10] / b[11];
+
+	/* speed */
+	prints(spd, "Memory Characteristics");
+
+	ctime = ddr3_mtb_ftb(b[12], b[34], mtb, ftb);
+	/*
+	 * Starting with DDR3-1866, vendors may start approximating the
+	 * minimum cycle time. Try to guess what they really meant so
+	 * that the reported speed matches the standard.
+	 */
+	for (ii = 7; ii < 15; ii++) {
+		if (ctime > 7.5 / ii - ftb / 1000
+		 && ctime < 7.5 / ii + ftb / 1000) {
+			ctime = 7.5 / ii;
+			break;
+		}
+	}
+
+	ddrclk = 2 * (1000 / ctime);
+	tbits = 1 << ((b[8] & 7) + 3);
+	pcclk = (int)(ddrclk * tbits / 8);
+	/* Round down to comply with Jedec */
+	pcclk -= pcclk % 100;
+	printl(spd, "Maximum module speed", "%d MHz (PC3-%d)", (int)ddrclk,
+	       pcclk);
+
+	/* Size computation */
+	cap = (b[4] & 15) + 28;
+	cap += (b[8] & 7) + 3;
+	cap -= (b[7] & 7) + 2;
+	cap -= 20 + 3;
+	k = ((b[7] >> 3) & 31) + 1;
+	if (cap >= 0)
+		printl(spd, "Size", "%.0f MB", ldexp(k, cap));
+	else
+		printl(spd, "Size", "%g MB", ldexp(k, cap));
+
+	printl(spd, "Banks x Rows x Columns x Bits", "%d x %d x %d x %d",
+	       1 << (((b[4] >> 4) & 7) + 3), ((b[5] >> 3) & 31) + 12,
+	       (b[5] & 7) + 9, 1 << ((b[8] & 7) + 3));
+	printl(spd, "Ranks", "%d", k);
+	printl(spd, "SDRAM Device Width", "%d bits", 1 << ((b[7] & 7) + 2));
+	printl(spd, "Bus Width Extension", "%d bits", b[8] & 24);
+
+	taa = ddr3_mtb_ftb(b[16], b[35], mtb, ftb);
+	trcd = ddr3_mtb_ftb(b[18], b[36], mtb, ftb);
+	trp = ddr3_mtb_ftb(b[20], b[37], mtb, ftb);
+	tras = (((b[21] & 0x0f) << 8) + b[22]) * mtb;
+
+	printl(spd, "tCL-tRCD-tRP-tRAS", "%s",
+	       ddr_core_timings(ceil(taa / ctime), ctime, trcd, trp, tras,
+				t1, sizeof(t1)));
+
+	/* latencies */
+	cas_sup = (b[15] << 8) + b[14];
+	for (ii = 0; ii < 15; ii++)
+		if (cas_sup & (1 << ii))
+			cas2[ncas++] = 2 * (ii + 4);
+	printl(spd, "Supported CAS Latencies (tCL)", "%s",
+	       cas_latencies(cas2, ncas, t1, sizeof(t1)));
+
+	/* standard DDR3 speeds */
+	prints(spd, "Timings at Standard Speeds");
+	for (i = 0; i < 6; i++) {
+		double ct = speeds[i];
+		int best_cas = 0;
+		char label[96];
+
+		/* Find min CAS latency at this speed */
+		for (ii = 14; ii >= 0; ii--) {
+			if (!(cas_sup & (1 << ii)))
+				continue;
+			if (ceil(taa / ct) <= ii + 4)
+				best_cas = ii + 4;
+		}
+
+		if (!best_cas || ct < ctime)
+			continue;
+		snprintf(label, sizeof(label), "tCL-tRCD-tRP-tRAS%s",
+			 as_ddr(3, ct, t2, sizeof(t2)));
+		printl(spd, label, "%s", ddr_core_timings(best_cas, ct, trcd,
+							 trp, tras, t1,
+							 sizeof(t1)));
+	}
+
+	/* more timing information */
+	prints(spd, "Timing Parameters");
+	printl(spd, "Minimum Cycle Time (tCK)", "%s",
+	       tns3(ctime, t1, sizeof(t1)));
+	printl(spd, "Minimum CAS Latency Time (tAA)", "%s",
+	       tns3(taa, t1, sizeof(t1)));
+	printl(spd, "Minimum Write Recovery time (tWR)", "%s",
+	       tns3(b[17] * mtb, t1, sizeof(t1)));
+	printl(spd, "Minimum RAS# to CAS# Delay (tRCD)", "%s",
+	       tns3(trcd, t1, sizeof(t1)));
+	printl(spd, "Minimum Row Active to Row Active Delay (tRRD)", "%s",
+	       tns3(b[19] * mtb, t1, sizeof(t1)));
+	printl(spd, "Minimum Row Precharge Delay (tRP)", "%s",
+	       tns3(trp, t1, sizeof(t1)));
+	printl(spd, "Minimum Active to Precharge Delay (tRAS)", "%s",
+	       tns3(tras, t1, sizeof(t1)));
+	printl(spd, "Minimum Active to Auto-Refresh Delay (tRC)", "%s",
+	       tns3(ddr3_mtb_ftb(((b[21] & 0xf0) << 4) + b[23], b[38], mtb,
+				 ftb), t1, sizeof(t1)));
+	printl(spd, "Minimum Recovery Delay (tRFC)", "%s",
+	       tns3(((b[25] << 8) + b[24]) * mtb, t1, sizeof(t1)));
+	printl(spd, "Minimum Write to Read CMD Delay (tWTR)", "%s",
+	       tns3(b[26] * mtb, t1, sizeof(t1)));
+	printl(spd, "Minimum Read to Pre-charge CMD Delay (tRTP)", "%s",
+	       tns3(b[27] * mtb, t1, sizeof(t1)));
+	printl(spd, "Minimum Four Activate Window Delay (tFAW)", "%s",
+	       tns3((((b[28] & 15) << 8) + b[29]) * mtb, t1, sizeof(t1)));
+
+	/* miscellaneous stuff */
+	prints(spd, "Optional Features");
+
+	sb.len = 0;
+	sb.s[0] = '\0';
+	sb_add(&sb, "1.5V");
+	if (b[6] & 1)
+		sb_add(&sb, " tolerant");
+	if (b[6] & 2)
+		sb_add(&sb, ", 1.35V ");
+	if (b[6] & 4)
+		sb_add(&sb, ", 1.2X V");
+	printl(spd, "Operable voltages", "%s", sb.s);
+	printl(spd, "RZQ/6 supported?", "%s", b[30] & 1 ? "Yes" : "No");
+	printl(spd, "RZQ/7 supported?", "%s", b[30] & 2 ? "Yes" : "No");
+	printl(spd, "DLL-Off Mode supported?", "%s",
+	       b[30] & 128 ? "Yes" : "No");
+	printl(spd, "Operating temperature range", "0-%d degrees C",
+	       b[31] & 1 ? 95 : 85);
+	if (b[31] & 1)
+		printl(spd, "Refresh Rate in extended temp range", "%s",
+		       b[31] & 2 ? "1X" : "2X");
+	printl(spd, "Auto Self-Refresh?", "%s", b[31] & 4 ? "Yes" : "No");
+	printl(spd, "On-Die Thermal Sensor readout?", "%s",
+	       b[31] & 8 ? "Yes" : "No");
+	printl(spd, "Partial Array Self-Refresh?", "%s",
+	       b[31] & 128 ? "Yes" : "No");
+	printl(spd, "Module Thermal Sensor", "%s", b[32] & 128 ? "Yes" : "No");
+	printl(spd, "SDRAM Device Type", "%s",
+	       ddr3_device_type(b[33], t1, sizeof(t1)));
+
+	/*
+	 * Following bytes are type-specific, so don't continue if type
+	 * isn't known.
+	 */
+	if (family == DDR3_UNDEFINED)
+		return;
+
+	prints(spd, "Physical Characteristics");
+	printl(spd, "Module Height", "%d mm", (b[60] & 31) + 15);
+	printl(spd, "Module Thickness", "%d mm front, %d mm back",
+	       (b[61] & 15) + 1, ((b[61] >> 4) & 15) + 1);
+	printl(spd, "Module Width", "%s", ddr3_module_types[b[3]].width);
+	printl(spd, "Module Reference Card", "%s",
+	       ddr3_reference_card(b[62], b[60], t1, sizeof(t1)));
+	if (family == DDR3_UNBUFFERED)
+		printl(spd, "Rank 1 Mapping", "%s",
+		       b[63] & 0x01 ? "Mirrored" : "Standard");
+
+	if (family == DDR3_REGISTERED) {
+		static const char *const rows[] = { "Undefined", "1", "2", "4" };
+
+		prints(spd, "Registered DIMM");
+		printl(spd, "# DRAM Rows", "%s", rows[(b[63] >> 2) & 3]);
+		printl(spd, "# Registers", "%s", rows[b[63] & 3]);
+		printl(spd, "Register manufacturer", "%s",
+		       manufacturer_ddr3(b[65], b[66], t1, sizeof(t1)));
+		printl(spd, "Register device type", "%s",
+		       (b[68] & 7) == 0 ? "SSTE32882" : "Undefined");
+		if (b[67] != 0xff)
+			printl(spd, "Register revision", "%s",
+			       ddr3_revision_number(b[67], t2, sizeof(t2)));
+		printl(spd, "Heat spreader", "%s", b[64] & 0x80 ? "Yes" : "No");
+	}
+
+	if (family == DDR3_LOAD_REDUCED) {
+		static const char *const rows[] = {
+			"Undefined", "1", "2", "Reserved"
+		};
+		static const char *const mirroring[] = {
+			"None", "Odd ranks", "Reserved", "Reserved"
+		};
+
+		prints(spd, "Load Reduced DIMM");
+		printl(spd, "# DRAM Rows", "%s", rows[(b[63] >> 2) & 3]);
+		printl(spd, "Mirroring", "%s", mirroring[b[63] & 3]);
+		printl(spd, "Rank Numbering", "%s",
+		       b[63] & 0x20 ? "Even only" : "Contiguous");
+		printl(spd, "Buffer Orientation", "%s",
+		       b[63] & 0x10 ? "Horizontal" : "Vertical");
+		printl(spd, "Register manufacturer", "%s",
+		       manufacturer_ddr3(b[65], b[66], t1, sizeof(t1)));
+		if (b[64] != 0xff)
+			printl(spd, "Buffer Revision", "%s",
+			       ddr3_revision_number(b[64], t2, sizeof(t2)));
+		printl(spd, "Heat spreader", "%s", b[63] & 0x80 ? "Yes" : "No");
+	}
+}
+
+/* Parameter: EEPROM bytes 0-127 (using 4-5) */
+static void decode_direct_rambus(struct spd_decoded *spd,
+				 const unsigned char *b)
+{
+	int ii;
+
+	prints(spd, "Memory Characteristics");
+
+	ii = (b[4] & 0x0f) + (b[4] >> 4) + (b[5] & 0x07) - 13;
+	if (ii > 0 && ii < 16)
+		printl(spd, "Size", "%d MB", 1 << ii);
+	else
+		printl(spd, "Size", "INVALID: 0x%02x, 0x%02x", b[4], b[5]);
+}
+
+/* Parameter: EEPROM bytes 0-127 (using 3-5) */
+static void decode_rambus(struct spd_decoded *spd, const unsigned char *b)
+{
+	int ii;
+
+	prints(spd, "Memory Characteristics");
+
+	ii = (b[3] & 0x0f) + (b[3] >> 4) + (b[5] & 0x07) - 13;
+	if (ii > 0 && ii < 16)
+		printl(spd, "Size", "%d MB", 1 << ii);
+	else
+		printl(spd, "Size", "INVALID: 0x%02x, 0x%02x", b[3], b[5]);
+}
+
+/*
+ * Manufacturing information
+ */
+
+/* Parameter: Manufacturing year/week bytes */
+static void printl_manufacture_date(struct spd_decoded *spd, int year,
+				    int week)
+{
+	/*
+	 * In theory the year and week are in BCD format, but
+	 * this is not always true in practice :(
+	 */
+	if ((year & 0xf0) <= 0x90 && (year & 0x0f) <= 0x09
+	 && (week & 0xf0) <= 0x90 && (week & 0x0f) <= 0x09)
+		/* Note that this heuristic will break in year 2080 */
+		printl(spd, "Manufacturing Date", "%d%02X-W%02X",
+		       year >= 0x80 ? 19 : 20, year, week);
+	/* Fallback to binary format if it seems to make sense */
+	else if (year <= 99 && week >= 1 && week <= 53)
+		printl(spd, "Manufacturing Date", "%d%02d-W%02d",
+		       year >= 80 ? 19 : 20, year, week);
+	else
+		printl(spd, "Manufacturing Date", "0x%02X%02X", year, week);
+}
+
+static void printl_mfg_location_code(struct spd_decoded *spd, int code)
+{
+	unsigned char c = code;
+
+	if (!spd_written(&c, 1))
+		return;
+
+	/*
+	 * Try the location code as ASCII first, as earlier specifications
+	 * suggested this. As newer specifications don't mention it anymore,
+	 * we still fall back to binary.
+	 */
+	if ((code >= '0' && code <= '9') || (code >= 'A' && code <= 'Z')
+	 || (code >= 'a' && code <= 'z') || code == '_')
+		printl(spd, "Manufacturing Location Code", "%c", code);
+	else
+		printl(spd, "Manufacturing Location Code", "0x%.2X", code);
+}
+
+static void printl_mfg_assembly_serial(struct spd_decoded *spd,
+				       const unsigned char *b)
+{
+	if (spd_written(b, 4))
+		printl(spd, "Assembly Serial Number", "0x%02X%02X%02X%02X",
+		       b[0], b[1], b[2], b[3]);
+}
+
+/* Parameter: EEPROM bytes 0-175 (using 117-149) */
+static void decode_ddr3_mfg_data(struct spd_decoded *spd,
+				 const unsigned char *b)
+{
+	char t1[64];
+
+	prints(spd, "Manufacturer Data");
+
+	printl(spd, "Module Manufacturer", "%s",
+	       manufacturer_ddr3(b[117], b[118], t1, sizeof(t1)));
+	if (spd_written(b + 148, 2))
+		printl(spd, "DRAM Manufacturer", "%s",
+		       manufacturer_ddr3(b[148], b[149], t1, sizeof(t1)));
+
+	printl_mfg_location_code(spd, b[119]);
+	if (spd_written(b + 120, 2))
+		printl_manufacture_date(spd, b[120], b[121]);
+	printl_mfg_assembly_serial(spd, b + 122);
+	printl(spd, "Part Number", "%s", part_number(b + 128, 18, t1));
+	if (spd_written(b + 146, 2))
+		printl(spd, "Revision Code", "0x%02X%02X", b[146], b[147]);
+}
+
+/* Parameter: EEPROM bytes 0-127 (using 64-98) */
+static void decode_manufacturing_information(struct spd_decoded *spd,
+					     const unsigned char *b)
+{
+	struct strbuf hex = { "", 0 }, asc = { "", 0 };
+	const char *name;
+	char t1[64];
+	int ai = 0, i;
+
+	prints(spd, "Manufacturing Information");
+
+	/*
+	 * Up to 7 extra bytes may follow the manufacturer code in its
+	 * field. Sometimes these bytes are filled with interesting data.
+	 */
+	if (!spd_written(b + 64, 8)) {
+		name = "Undefined";
+		ai = 8;
+	} else {
+		while (ai < 8 && b[64 + ai] == 0x7f)
+			ai++;
+		name = ai < 8 ? manufacturer_common(ai, b[64 + ai]) :
+		       "Invalid";
+	}
+	printl(spd, "Manufacturer", "%s", name);
+
+	if (ai + 1 < 8 && spd_written(b + 65 + ai, 7 - ai)) {
+		for (i = 65 + ai; i < 72; i++) {
+			sb_add(&hex, "%02X ", b[i]);
+			sb_add(&asc, "%c", b[i] >= 32 && b[i] < 127 ?
+			       b[i] : '?');
+		}
+		printl(spd, "Custom Manufacturer Data", "%s(\"%s\")", hex.s,
+		       asc.s);
+	}
+
+	printl_mfg_location_code(spd, b[72]);
+	printl(spd, "Part Number", "%s", part_number(b + 73, 18, t1));
+	if (spd_written(b + 91, 2))
+		printl(spd, "Revision Code", "0x%02X%02X", b[91], b[92]);
+	if (spd_written(b + 93, 2))
+		printl_manufacture_date(spd, b[93], b[94]);
+	printl_mfg_assembly_serial(spd, b + 95);
+}
+
+/* Parameter: EEPROM bytes 0-127 (using 126-127) */
+static void decode_intel_spec_freq(struct spd_decoded *spd,
+				   const unsigned char *b)
+{
+	struct strbuf sb = { "", 0 };
+
+	prints(spd, "Intel Specification");
+
+	printl(spd, "Frequency", "%s", b[126] == 0x66 ? "66 MHz" :
+	       b[126] == 100 ? "100 MHz or 133 MHz" :
+	       b[126] == 133 ? "133 MHz" : "Undefined!");
+
+	if (b[127] & 1)
+		sb_add(&sb, "Intel Concurrent Auto-precharge\n");
+	if (b[127] & 2)
+		sb_add(&sb, "CAS Latency = 2\n");
+	if (b[127] & 4)
+		sb_add(&sb, "CAS Latency = 3\n");
+	if (b[127] & 8)
+		sb_add(&sb, "Junction Temp A (100 degrees C)\n");
+	else
+		sb_add(&sb, "Junction Temp B (90 degrees C)\n");
+	if (b[127] & 16)
+		sb_add(&sb, "CLK 3 Connected\n");
+	if (b[127] & 32)
+		sb_add(&sb, "CLK 2 Connected\n");
+	if (b[127] & 64)
+		sb_add(&sb, "CLK 1 Connected\n");
+	if (b[127] & 128)
+		sb_add(&sb, "CLK 0 Connected\n");
+	if ((b[127] & 192) == 192)
+		sb_add(&sb, "Double-sided DIMM\n");
+	else if ((b[127] & 192) != 0)
+		sb_add(&sb, "Single-sided DIMM\n");
+	printl(spd, "Details for 100 MHz Support", "%s", sb_str(&sb));
+}
+
+/*
+ * Checksums
+ */
+
+/* Calculate and verify checksum of first 63 bytes */
+static void checksum(struct spd_decoded *spd, const unsigned char *b)
+{
+	int i, sum = 0;
+
+	for (i = 0; i <= 62; i++)
+		sum += b[i];
+	sum &= 0xff;
+
+	spd->checksum_ok = b[63] == sum;
+	if (spd->checksum_ok)
+		printl(spd, "EEPROM Checksum of bytes 0-62", "OK (0x%02X)",
+		       sum);
+	else
+		printl(spd, "EEPROM Checksum of bytes 0-62",
+		       "Bad\n(found 0x%02X, calculated 0x%02X)", b[63], sum);
+}
+
+/* Calculate and verify CRC */
+static void check_crc(struct spd_decoded *spd, const unsigned char *b)
+{
+	int cover = b[0] & 0x80 ? 116 : 125;
+	int i, bit, crc = 0, dimm_crc;
+	char label[96];
+
+	for (i = 0; i <= cover; i++) {
+		crc ^= b[i] << 8;
+		for (bit = 0; bit < 8; bit++)
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	crc &= 0xffff;
+
+	dimm_crc = (b[127] << 8) | b[126];
+	spd->checksum_ok = dimm_crc == crc;
+	snprintf(label, sizeof(label), "EEPROM CRC of bytes 0-%d", cover);
+	if (spd->checksum_ok)
+		printl(spd, label, "OK (0x%04X)", crc);
+	else
+		printl(spd, label, "Bad\n(found 0x%04X, calculated 0x%04X)",
+		       dimm_crc, crc);
+}
+
+/*
+ * Main entry point
+ */
+
+static const char *const type_list[] = {
+	"Reserved", "FPM DRAM",		/* 0, 1 */
+	"EDO", "Pipelined Nibble",	/* 2, 3 */
+	"SDR SDRAM", "Multiplexed ROM",	/* 4, 5 */
+	"DDR SGRAM", "DDR SDRAM",	/* 6, 7 */
+	"DDR2 SDRAM", "FB-DIMM",	/* 8, 9 */
+	"FB-DIMM Probe", "DDR3 SDRAM",	/* 10, 11 */
+};
+
+int spd_decode(const unsigned char *bytes, int len, struct spd_decoded *spd)
+{
+	unsigned char b[SPD_MAX_SIZE];
+	int is_rambus, used;
+
+	memset(spd, 0, sizeof(*spd));
+	if (len < 128)
+		return -EINVAL;
+
+	/* Missing bytes read as 0xff, like an unprogrammed EEPROM */
+	memset(b, 0xff, sizeof(b));
+	memcpy(b, bytes, len < SPD_MAX_SIZE ? len : SPD_MAX_SIZE);
+
+	is_rambus = b[0] < 4;		/* Simple heuristic */
+	spd->type = "Unknown";
+	if (is_rambus) {
+		if (b[2] == 1)
+			spd->type = "Direct Rambus";
+		else if (b[2] == 17)
+			spd->type = "Rambus";
+	} else if (b[2] < sizeof(type_list) / sizeof(type_list[0])) {
+		spd->type = type_list[b[2]];
+	}
+
+	/* Decode first 3 bytes (0-2) */
+	prints(spd, "SPD EEPROM Information");
+
+	if (is_rambus || b[2] < 9)
+		checksum(spd, b);
+	else
+		check_crc(spd, b);
+
+	if (is_rambus) {
+		printl(spd, "SPD Revision", "%s", b[0] == 1 ? "0.7" :
+		       b[0] == 2 ? "1.0" : b[0] == 0 ? "Invalid" : "Reserved");
+	} else {
+		int total = 0;
+
+		if (b[2] >= 9) {
+			/* For FB-DIMM and newer, decode number of bytes written */
+			if (((b[0] >> 4) & 7) <= 2) {
+				used = spd_used_size(b);
+				total = 64 << (b[0] & 15);
+			} else {
+				total = used = 64;
+			}
+		} else {
+			if (b[1] <= 14)
+				total = 1 << b[1];
+			used = b[0] < 64 ? 64 : b[0];
+		}
+		printl(spd, "# of bytes written to SDRAM EEPROM", "%d", used);
+		if (total)
+			printl(spd, "Total number of bytes in EEPROM", "%d",
+			       total);
+		else
+			printl(spd, "Total number of bytes in EEPROM",
+			       "ERROR!");
+	}
+
+	if (!strcmp(spd->type, "Unknown"))
+		printl(spd, "Fundamental Memory type", "Unknown (0x%02x)",
+		       b[2]);
+	else
+		printl(spd, "Fundamental Memory type", "%s", spd->type);
+
+	/* Decode next 61 bytes (3-63, depend on memory type) */
+	if (!strcmp(spd->type, "SDR SDRAM"))
+		decode_sdr_sdram(spd, b);
+	else if (!strcmp(spd->type, "DDR SDRAM"))
+		decode_ddr_sdram(spd, b);
+	else if (!strcmp(spd->type, "DDR2 SDRAM"))
+		decode_ddr2_sdram(spd, b);
+	else if (!strcmp(spd->type, "DDR3 SDRAM"))
+		decode_ddr3_sdram(spd, b);
+	else if (!strcmp(spd->type, "Direct Rambus"))
+		decode_direct_rambus(spd, b);
+	else if (!strcmp(spd->type, "Rambus"))
+		decode_rambus(spd, b);
+
+	if (!strcmp(spd->type, "DDR3 SDRAM"))
+		/* Decode DDR3-specific manufacturing data in bytes 117-149 */
+		decode_ddr3_mfg_data(spd, b);
+	else
+		/* Decode next 35 bytes (64-98, common to most memory types) */
+		decode_manufacturing_information(spd, b);
+
+	/*
+	 * Next 27 bytes (99-125) are manufacturer specific, can't decode.
+	 * Last 2 bytes (126-127) are reserved, Intel used them as an
+	 * extension.
+	 */
+	if (!strcmp(spd->type, "SDR SDRAM"))
+		decode_intel_spec_freq(spd, b);
+
+	if (spd->error) {
+		int err = spd->error;
+
+		spd_free(spd);
+		return err;
+	}
+	return 0;
+}
+
+void spd_free(struct spd_decoded *spd)
+{
+	int i;
+
+	for (i = 0; i < spd->nfields; i++) {
+		free(spd->fields[i].label);
+		free(spd->fields[i].value);
+	}
+	free(spd->fields);
+	memset(spd, 0, sizeof(*spd));
+}
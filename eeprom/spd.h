@@ -0,0 +1,68 @@
+/*
+    spd.h - Memory module Serial Presence Detect decoding
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    Based on decode-dimms:
+    Copyright 1998, 1999 Philip Edelbrock <phil@netroedge.com>
+    Copyright (C) 2005-2013  Jean Delvare <jdelvare@suse.de>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef _SPD_H
+#define _SPD_H
+
+#define SPD_MAX_SIZE	256	/* what we may ever need to decode */
+
+/*
+ * Decoded SPD data, as a list of label/value fields in the order and
+ * with the wording of decode-dimms. Fields with a NULL value start a
+ * new section, named by their label. Values may span several lines.
+ */
+struct spd_field {
+	char *label;
+	char *value;
+};
+
+struct spd_decoded {
+	const char *type;	/* fundamental memory type */
+	int checksum_ok;	/* checksum or CRC valid */
+	struct spd_field *fields;
+	int nfields, max_fields;
+	int error;		/* set while decoding on allocation failure */
+};
+
+/*
+ * Read the SPD data from path: a sysfs device directory with an eeprom
+ * attribute, or a binary file. Only the bytes the SPD data says are used
+ * are read, and the file is opened once. Returns the number of bytes
+ * read, or a negative errno value.
+ */
+extern int spd_read(const char *path, unsigned char *bytes, int size);
+
+/*
+ * Number of bytes worth reading, based on the first 3 bytes of the SPD
+ * data. At least 128 (or 64 for old or unknown EEPROMs) and at most
+ * SPD_MAX_SIZE.
+ */
+extern int spd_used_size(const unsigned char *bytes);
+
+/* Returns 0 or a negative errno value */
+extern int spd_decode(const unsigned char *bytes, int len,
+		      struct spd_decoded *spd);
+extern void spd_free(struct spd_decoded *spd);
+
+#endif /* _SPD_H */
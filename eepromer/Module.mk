@@ -16,14 +16,14 @@ EEPROMER_TARGETS	:= eepromer eeprom eeprog
 # Programs
 #
 
-$(EEPROMER_DIR)/eepromer: $(EEPROMER_DIR)/eepromer.o
-	$(CC) $(LDFLAGS) -o $@ $^ $(EEPROMER_LDFLAGS)
+$(EEPROMER_DIR)/eepromer: $(EEPROMER_DIR)/eepromer.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROMER_LDFLAGS)
 
-$(EEPROMER_DIR)/eeprom: $(EEPROMER_DIR)/eeprom.o
-	$(CC) $(LDFLAGS) -o $@ $^ $(EEPROMER_LDFLAGS)
+$(EEPROMER_DIR)/eeprom: $(EEPROMER_DIR)/eeprom.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROMER_LDFLAGS)
 
-$(EEPROMER_DIR)/eeprog: $(EEPROMER_DIR)/eeprog.o $(EEPROMER_DIR)/24cXX.o 
-	$(CC) $(LDFLAGS) -o $@ $^ $(EEPROMER_LDFLAGS)
+$(EEPROMER_DIR)/eeprog: $(EEPROMER_DIR)/eeprog.o $(EEPROMER_DIR)/24cXX.o $(LIB_DEPS)
+	$(CC) $(LDFLAGS) -o $@ $(filter %.o,$^) $(EEPROMER_LDFLAGS)
 
 #
 # Objects
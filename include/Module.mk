@@ -9,7 +9,7 @@
 
 INCLUDE_DIR	:= include
 
-INCLUDE_TARGETS	:= i2c/smbus.h i2c/busses.h
+INCLUDE_TARGETS	:= i2c/smbus.h i2c/busses.h i2c/monitor.h i2c/trace.h i2c/xfer.h i2c/handle.h i2c/stats.h i2c/shmstats.h
 
 #
 # Commands
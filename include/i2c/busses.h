@@ -32,4 +32,11 @@ extern int i2c_set_slave_addr(int file, int address, int force);
 extern int i2c_set_adapter_timeout(int file, int timeout);
 extern int i2c_set_adapter_retries(int file, int retries);
 
+/*
+ * Enable or disable SMBus PEC on a file (I2C_PEC ioctl), so that the
+ * statistics count the PEC bytes on the wire. Returns 0 or a negative
+ * errno value, without printing anything.
+ */
+extern int i2c_set_pec(int file, int pec);
+
 #endif /* LIB_I2C_BUSSES_H */
@@ -0,0 +1,101 @@
+/*
+    handle.h - I2C adapter handles with per-adapter operation dispatch
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_HANDLE_H
+#define LIB_I2C_HANDLE_H
+
+#include <linux/types.h>
+#include <i2c/xfer.h>
+
+/*
+ * A handle wraps an open i2c-dev file. When it is created, the adapter
+ * functionality is looked up once, and the fastest implementation of
+ * each operation below is selected, so that calls don't need to check
+ * capabilities again. The adapter transfer limits are only probed, and
+ * the selection redone, the first time an operation is refused with
+ * -EOPNOTSUPP. Operations the adapter can't do at all return -EOPNOTSUPP.
+ *
+ * Plain I2C transfers (see xfer.h) are preferred when the adapter can do
+ * combined transfers, as they carry the slave address and don't need an
+ * extra ioctl to switch devices. Otherwise SMBus transactions are used,
+ * and the slave address is set as needed, without forcing it, so a
+ * device claimed by a kernel driver can't be accessed that way (-EBUSY).
+ *
+ * Handles are not thread-safe if they may use SMBus transactions.
+ */
+struct i2c_handle;
+
+enum i2c_handle_op {
+	I2C_OP_READ_BYTE_DATA,
+	I2C_OP_WRITE_BYTE_DATA,
+	I2C_OP_READ_WORD_DATA,
+	I2C_OP_WRITE_WORD_DATA,
+	I2C_OP_READ_BLOCK_DATA,
+	I2C_OP_WRITE_BLOCK_DATA,
+	I2C_OP_READ_BULK,
+	I2C_OP_COUNT
+};
+
+/*
+ * i2c_handle_open() opens /dev/i2c-<i2cbus>, and i2c_handle_close()
+ * closes it. i2c_handle_new() wraps a file opened by the caller, which
+ * i2c_handle_close() leaves open. Both return NULL and set errno on
+ * error.
+ */
+extern struct i2c_handle *i2c_handle_open(int i2cbus);
+extern struct i2c_handle *i2c_handle_new(int file);
+extern void i2c_handle_close(struct i2c_handle *handle);
+
+extern int i2c_handle_file(const struct i2c_handle *handle);
+extern unsigned long i2c_handle_functionality(const struct i2c_handle *handle);
+
+/* Name of the implementation selected for op, or NULL if unsupported */
+extern const char *i2c_handle_impl(const struct i2c_handle *handle,
+				   enum i2c_handle_op op);
+extern const char *i2c_handle_op_name(enum i2c_handle_op op);
+
+extern __s32 i2c_handle_read_byte_data(struct i2c_handle *handle, __u16 addr,
+				       __u8 command);
+extern __s32 i2c_handle_write_byte_data(struct i2c_handle *handle, __u16 addr,
+					__u8 command, __u8 value);
+extern __s32 i2c_handle_read_word_data(struct i2c_handle *handle, __u16 addr,
+				       __u8 command);
+extern __s32 i2c_handle_write_word_data(struct i2c_handle *handle, __u16 addr,
+					__u8 command, __u16 value);
+
+/* SMBus block transfers; returns the number of read bytes */
+extern __s32 i2c_handle_read_block_data(struct i2c_handle *handle, __u16 addr,
+					__u8 command, __u8 *values);
+extern __s32 i2c_handle_write_block_data(struct i2c_handle *handle, __u16 addr,
+					 __u8 command, __u8 length,
+					 const __u8 *values);
+
+/*
+ * Reads length bytes of consecutive registers, starting at offset, and
+ * returns the number of bytes read. I2C_XFER_OFFSET16 is only supported
+ * with plain I2C transfers; SMBus implementations read 8-bit offsets,
+ * which wrap around at 0xff.
+ */
+extern __s32 i2c_handle_read_bulk(struct i2c_handle *handle, __u16 addr,
+				  __u16 flags, unsigned int offset,
+				  __u8 *values, unsigned int length);
+
+#endif /* LIB_I2C_HANDLE_H */
@@ -0,0 +1,63 @@
+/*
+    monitor.h - I2C adapter hotplug notifications
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_MONITOR_H
+#define LIB_I2C_MONITOR_H
+
+#define I2C_ADAPTER_NAME_MAX	120
+
+/* Event types */
+#define I2C_ADAPTER_ADD		1
+#define I2C_ADAPTER_REMOVE	2
+
+/* Flags for i2c_monitor_open() */
+#define I2C_MONITOR_INITIAL	0x01	/* Report present adapters as added */
+
+struct i2c_adapter_event {
+	int type;
+	int nr;				/* i2c-dev bus number */
+	char name[I2C_ADAPTER_NAME_MAX];
+};
+
+struct i2c_monitor;
+
+/*
+ * Watch <sysfs_root>/class/i2c-dev for adapters coming and going. With
+ * sysfs_root == NULL, the real sysfs is used and changes are reported by
+ * kernel uevents. With any other root (typically a fake tree for testing),
+ * the directory is watched with inotify; new adapter directories should
+ * then be moved into place with their name file already present.
+ * Returns NULL and sets errno on failure.
+ */
+extern struct i2c_monitor *i2c_monitor_open(const char *sysfs_root, int flags);
+extern void i2c_monitor_close(struct i2c_monitor *mon);
+
+/* File descriptor to poll() for readability */
+extern int i2c_monitor_get_fd(const struct i2c_monitor *mon);
+
+/*
+ * Fetch the next pending event without blocking. Returns 1 if an event
+ * was stored, 0 if there is none, or a negative errno value.
+ */
+extern int i2c_monitor_read_event(struct i2c_monitor *mon,
+				  struct i2c_adapter_event *event);
+
+#endif /* LIB_I2C_MONITOR_H */
@@ -0,0 +1,97 @@
+/*
+    shmstats.h - I2C transaction statistics published in shared memory
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_SHMSTATS_H
+#define LIB_I2C_SHMSTATS_H
+
+#include <linux/types.h>
+#include <i2c/stats.h>
+
+/*
+ * A process publishing its statistics maps the file I2C_SHM_PREFIX<pid>,
+ * holding a header followed by I2C_SHM_SLOTS slots, one per (bus,
+ * address) pair, claimed on first use. Transactions are not counted
+ * once all slots are taken. Files are removed at exit. A forked child
+ * publishes its own file, starting with its first transaction.
+ *
+ * Each slot is a seqlock: the writer makes seq odd while it updates the
+ * counters, so readers never block the process, they just retry when
+ * seq was odd or changed while they copied the counters. All fields are
+ * in host byte order.
+ */
+#define I2C_SHM_PREFIX		"/dev/shm/libi2c."
+#define I2C_SHM_MAGIC		"I2CSHM"
+#define I2C_SHM_VERSION		1
+#define I2C_SHM_SLOTS		256
+
+struct i2c_shm_counters {
+	__u64 transactions;
+	__u64 bytes;		/* data bytes of successful transactions */
+	__u64 failed;
+	__u64 total_ns;
+	__u64 max_ns;
+	__u64 wire_bits;
+	__u64 latency[I2C_STATS_BUCKETS];	/* as in struct i2c_stats */
+};
+
+struct i2c_shm_slot {
+	__u32 seq;
+	__u32 key;		/* ((bus << 16) | address) + 1, 0 if free */
+	struct i2c_shm_counters counters;
+};
+
+struct i2c_shm_header {
+	char magic[6];
+	__u8 version;
+	__u8 reserved;
+	__u32 pid;
+	__u32 nr_slots;
+	__u32 reserved2;
+};
+
+/*
+ * Publishing: once started, the transactions of the calling process are
+ * counted per bus and address in its shared memory file. Also started
+ * at library load time if the I2C_STATS_SHM environment variable is
+ * set. Returns 0 or a negative errno value.
+ */
+extern int i2c_stats_publish(void);
+extern void i2c_stats_unpublish(void);
+
+/* Reading the file of another process. NULL and errno set on error. */
+struct i2c_shm_stats;
+
+extern struct i2c_shm_stats *i2c_shm_open(const char *path);
+extern void i2c_shm_close(struct i2c_shm_stats *shm);
+extern int i2c_shm_pid(const struct i2c_shm_stats *shm);
+
+/*
+ * Consistent copy of slot index, from 0 to I2C_SHM_SLOTS - 1, and the
+ * bus and address it counts. Address I2C_STATS_UNKNOWN counts
+ * transactions with no known address. Returns 1 if the slot is in use,
+ * 0 if it is free, -EBUSY if the process died while updating it, or
+ * -EINVAL if index is out of range.
+ */
+extern int i2c_shm_read(const struct i2c_shm_stats *shm, int index,
+			int *bus, int *addr,
+			struct i2c_shm_counters *counters);
+
+#endif /* LIB_I2C_SHMSTATS_H */
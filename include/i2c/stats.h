@@ -0,0 +1,103 @@
+/*
+    stats.h - I2C transaction statistics
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_STATS_H
+#define LIB_I2C_STATS_H
+
+#include <linux/types.h>
+
+#define I2C_STATS_BUCKETS	32	/* latency histogram size */
+#define I2C_STATS_ERRNOS	134	/* errno values counted one by one */
+
+#define I2C_STATS_ALL		-1	/* all addresses of a file */
+#define I2C_STATS_UNKNOWN	0x400	/* transactions with no known address */
+
+/*
+ * Counters for the transactions of one file to one slave address.
+ * Latencies are measured around each ioctl with CLOCK_MONOTONIC.
+ * latency[i] counts the transactions which took from 2^i to 2^(i+1)
+ * nanoseconds, the last bucket also counts all slower ones. errors[e]
+ * counts failures with errno e, errors[0] those with larger values.
+ * retries counts the transfers the library had to submit again, after
+ * the adapter refused them as they were. wire_bits counts the bus clock
+ * cycles of the transfers the adapter completed: one per start, repeated
+ * start and stop condition, and 9 (with ACK) per address, command, data,
+ * count and PEC byte (PEC being enabled with i2c_set_pec()). See
+ * i2c_stats_wire_ns().
+ */
+struct i2c_stats {
+	__u64 transactions;
+	__u64 bytes;		/* data bytes of successful transactions */
+	__u64 failed;
+	__u64 retries;
+	__u64 total_ns;
+	__u64 max_ns;
+	__u64 wire_bits;
+	__u64 latency[I2C_STATS_BUCKETS];
+	__u64 errors[I2C_STATS_ERRNOS];
+};
+
+/*
+ * Once started, every transaction going through libi2c is counted, per
+ * file and per slave address. When stopped, which is the default, the
+ * cost is a single test per transaction. Statistics are also started at
+ * library load time if the I2C_STATS environment variable is set, and
+ * a summary is then printed to stderr at exit.
+ *
+ * Files opened with i2c_open_i2c_dev() or i2c_handle_open() start with
+ * clean counters. Others should be reset by the caller if the descriptor
+ * was used for another file before.
+ */
+extern void i2c_stats_start(void);
+extern void i2c_stats_stop(void);
+
+/*
+ * Copy the counters of file for addr, which may be I2C_STATS_UNKNOWN,
+ * or I2C_STATS_ALL to sum all addresses. Counters are read while other
+ * threads may update them, so they may be slightly out of sync with
+ * each other. Returns 0, or -ENOENT if no such transaction was counted.
+ */
+extern int i2c_stats_get(int file, int addr, struct i2c_stats *stats);
+
+/* Clear the counters of file, or of all files if file is -1 */
+extern void i2c_stats_reset(int file);
+
+/* Latency under which pct percent of the transactions completed, in ns */
+extern __u64 i2c_stats_percentile(const struct i2c_stats *stats,
+				  unsigned int pct);
+
+/*
+ * Bus clock frequency of adapter i2cbus in Hz: as set last with
+ * i2c_set_bus_frequency(), or else the I2C_BUS_FREQ environment
+ * variable, or else the clock-frequency property of the adapter in the
+ * device tree, or else 100 kHz. Setting hz to 0 forgets about it.
+ */
+extern unsigned int i2c_get_bus_frequency(int i2cbus);
+extern void i2c_set_bus_frequency(int i2cbus, unsigned int hz);
+
+/*
+ * Time bits took on the wire at hz, in ns. This is what the bus
+ * needed at the very least; the difference with total_ns is the cost
+ * of clock stretching, of the adapter and of the software stack.
+ */
+extern __u64 i2c_stats_wire_ns(__u64 bits, unsigned int hz);
+
+#endif /* LIB_I2C_STATS_H */
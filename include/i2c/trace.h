@@ -0,0 +1,114 @@
+/*
+    trace.h - SMBus transaction recording and replay
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_TRACE_H
+#define LIB_I2C_TRACE_H
+
+#include <linux/types.h>
+#include <linux/i2c.h>
+
+#define I2C_TRACE_UNKNOWN	0xffff	/* bus or address not known */
+#define I2C_TRACE_RDWR		0xff	/* size of I2C_RDWR transfers */
+
+/*
+ * One transaction, as stored in a trace file. Plain I2C transfers only
+ * appear in timelines: their size is I2C_TRACE_RDWR, command is the
+ * first byte written, result the I2C_RDWR ioctl return value (number of
+ * messages or negative errno) and no data is kept.
+ */
+struct i2c_trace_record {
+	__u64 timestamp;	/* CLOCK_MONOTONIC at start, in ns */
+	__u32 duration;		/* in ns */
+	__s32 result;		/* i2c_smbus_access() return value */
+	__u32 tid;		/* thread ID, 0 if unknown */
+	__s32 fd;		/* file descriptor, -1 if unknown */
+	__u16 bus;
+	__u16 addr;
+	__u8 read_write;
+	__u8 command;
+	__u8 size;		/* I2C_SMBUS_* transaction type */
+	__u8 len;		/* number of valid bytes in data */
+	__u8 data[I2C_SMBUS_BLOCK_MAX + 2];	/* union i2c_smbus_data */
+};
+
+/*
+ * Recording: once started, every i2c_smbus_access() call is appended to
+ * the trace file. Recording also starts automatically at library load
+ * time if the I2C_RECORD environment variable names a file.
+ * Returns 0 or a negative errno value.
+ */
+extern int i2c_record_start(const char *path);
+extern void i2c_record_stop(void);
+
+/* Sequential reading of a trace file. NULL and errno set on error. */
+struct i2c_trace;
+
+extern struct i2c_trace *i2c_trace_open(const char *path);
+/* Returns 1 if a record was read, 0 at end of file, or a negative errno */
+extern int i2c_trace_read(struct i2c_trace *trace,
+			  struct i2c_trace_record *rec);
+extern void i2c_trace_close(struct i2c_trace *trace);
+
+/*
+ * Timeline: once started, the last records transactions of all threads,
+ * SMBus transactions and I2C transfers alike, are kept in memory in a
+ * ring buffer, at the cost of one atomic increment and a copy per
+ * transaction. Saving writes them to a trace file, oldest first; records
+ * being written at the same time are left out. The timeline also starts
+ * at library load time if the I2C_TIMELINE environment variable names a
+ * file, and is then saved to it at exit. Transfers implementing an SMBus
+ * transaction appear both on their own and as that transaction.
+ * Returns 0 or a negative errno value.
+ */
+#define I2C_TIMELINE_DEFAULT	16384	/* records */
+
+extern int i2c_timeline_start(unsigned int records);
+extern void i2c_timeline_stop(void);
+extern int i2c_timeline_save(const char *path);
+
+/*
+ * Replay: serve SMBus transactions from a trace instead of the bus.
+ * Transactions are matched on bus, address, direction, command and size,
+ * and successive matches return successive recorded answers, wrapping
+ * around at the end, so dynamic values play back in order. Writes which
+ * were never recorded succeed silently, reads return -ENXIO.
+ */
+struct i2c_replay;
+
+extern struct i2c_replay *i2c_replay_open(const char *path);
+extern __s32 i2c_replay_access(struct i2c_replay *replay, int bus, int addr,
+			       char read_write, __u8 command, int size,
+			       union i2c_smbus_data *data);
+extern void i2c_replay_close(struct i2c_replay *replay);
+
+/*
+ * Let i2c_smbus_access() itself be served from a trace, so unmodified
+ * programs talk to a userspace mock. Also started at library load time
+ * if the I2C_REPLAY environment variable names a file. Only the SMBus
+ * transactions are served from the trace: the bus device must still
+ * exist, typically created by i2c-stub, as opening it and the I2C_FUNCS
+ * and I2C_SLAVE ioctls go to the kernel.
+ * Returns 0 or a negative errno value.
+ */
+extern int i2c_replay_start(const char *path);
+extern void i2c_replay_stop(void);
+
+#endif /* LIB_I2C_TRACE_H */
@@ -0,0 +1,157 @@
+/*
+    xfer.h - SMBus transactions over I2C_RDWR, addressed per call
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_XFER_H
+#define LIB_I2C_XFER_H
+
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <stddef.h>
+
+#define I2C_XFER_PEC		0x0004	/* flag, same as kernel I2C_CLIENT_PEC */
+#define I2C_XFER_OFFSET16	0x0008	/* flag, 16-bit offsets for bulk reads */
+#define I2C_SMBUS3_BLOCK_MAX	255	/* SMBus 3.0 block length limit */
+#define I2C_XFER_MSG_MAX	8192	/* i2c-dev limit per message */
+
+/*
+ * These functions take the slave address as a parameter instead of
+ * relying on i2c_set_slave_addr(). Each transaction is encoded as a
+ * single I2C_RDWR ioctl, where every message carries its own address,
+ * so one file can be shared by many threads, and talk to many devices,
+ * without any locking or rebinding. The adapter must support
+ * I2C_FUNC_I2C, and I2C_FUNC_SMBUS_READ_BLOCK_DATA for SMBus block
+ * reads. Addresses already claimed by a kernel driver are accessible.
+ *
+ * flags may be I2C_M_TEN for 10-bit addresses, and I2C_XFER_PEC to use
+ * Packet Error Checking. PEC is computed and checked here rather than
+ * by the adapter driver; a bad PEC on a read returns -EBADMSG.
+ *
+ * i2c_smbus_xfer() has the same semantics as i2c_smbus_access(), and
+ * returns 0 or a negative errno value. The other functions behave like
+ * their i2c_smbus_* counterparts.
+ */
+extern __s32 i2c_smbus_xfer(int file, __u16 addr, __u16 flags,
+			    char read_write, __u8 command, int size,
+			    union i2c_smbus_data *data);
+
+extern __s32 i2c_xfer_write_quick(int file, __u16 addr, __u8 value);
+extern __s32 i2c_xfer_read_byte(int file, __u16 addr);
+extern __s32 i2c_xfer_write_byte(int file, __u16 addr, __u8 value);
+extern __s32 i2c_xfer_read_byte_data(int file, __u16 addr, __u8 command);
+extern __s32 i2c_xfer_write_byte_data(int file, __u16 addr, __u8 command,
+				      __u8 value);
+extern __s32 i2c_xfer_read_word_data(int file, __u16 addr, __u8 command);
+extern __s32 i2c_xfer_write_word_data(int file, __u16 addr, __u8 command,
+				      __u16 value);
+extern __s32 i2c_xfer_process_call(int file, __u16 addr, __u8 command,
+				   __u16 value);
+
+/* Returns the number of read bytes */
+extern __s32 i2c_xfer_read_block_data(int file, __u16 addr, __u8 command,
+				      __u8 *values);
+extern __s32 i2c_xfer_write_block_data(int file, __u16 addr, __u8 command,
+				       __u8 length, const __u8 *values);
+
+/* Returns the number of read bytes */
+extern __s32 i2c_xfer_read_i2c_block_data(int file, __u16 addr,
+					  __u8 command, __u8 length,
+					  __u8 *values);
+extern __s32 i2c_xfer_write_i2c_block_data(int file, __u16 addr,
+					   __u8 command, __u8 length,
+					   const __u8 *values);
+
+/* Returns the number of read bytes */
+extern __s32 i2c_xfer_block_process_call(int file, __u16 addr, __u8 command,
+					 __u8 length, __u8 *values);
+
+/*
+ * SMBus 3.0 block transfers of up to I2C_SMBUS3_BLOCK_MAX bytes; the
+ * read buffers must have room for that many bytes. Reads rely on the
+ * adapter driver accepting long I2C_M_RECV_LEN messages, most stop at
+ * 32 bytes and fail with -EPROTO past that.
+ */
+extern __s32 i2c_xfer_read_block(int file, __u16 addr, __u16 flags,
+				 __u8 command, __u8 *values);
+extern __s32 i2c_xfer_write_block(int file, __u16 addr, __u16 flags,
+				  __u8 command, __u8 length,
+				  const __u8 *values);
+extern __s32 i2c_xfer_block_process(int file, __u16 addr, __u16 flags,
+				    __u8 command, __u8 length,
+				    const __u8 *wvalues, __u8 *rvalues);
+
+/*
+ * Bulk transfers for EEPROMs and firmware images. The data goes straight
+ * between the caller's buffer and the I2C_RDWR messages, no copy.
+ *
+ * i2c_xfer_read() reads length bytes starting at offset, for devices
+ * which auto-increment their address pointer. The offset is sent as one
+ * byte, or two (MSB first) with I2C_XFER_OFFSET16. Reads are split in
+ * I2C_XFER_MSG_MAX-byte messages, each with its own offset, and as many
+ * of these as possible go in each ioctl. Returns the number of bytes
+ * read or a negative errno value.
+ *
+ * i2c_xfer_write() writes a single message of up to I2C_XFER_MSG_MAX
+ * bytes; buf starts with the offset byte(s), followed by the data.
+ * Returns length or a negative errno value.
+ *
+ * Both fall back to i2c_transfer() when the adapter refuses a transfer.
+ */
+extern __s32 i2c_xfer_read(int file, __u16 addr, __u16 flags,
+			   unsigned int offset, __u8 *values,
+			   unsigned int length);
+extern __s32 i2c_xfer_write(int file, __u16 addr, __u16 flags, __u8 *buf,
+			    unsigned int length);
+
+/*
+ * Adapter transfer limits, as enforced by the kernel before a transfer
+ * reaches the bus. They are probed once per adapter, with transfers to
+ * the reserved address 0x7f, and cached for the life of the process.
+ * Returns 0, or a negative errno value (-EOPNOTSUPP for adapters not
+ * capable of plain I2C transfers).
+ */
+struct i2c_adapter_quirks {
+	unsigned int max_read_len;	/* bytes per read message */
+	unsigned int max_write_len;	/* bytes per write message */
+	unsigned int max_msgs;		/* messages per I2C_RDWR ioctl */
+	int combined;			/* write then read, repeated start */
+	int pairs_only;			/* only write then read in 2 msgs */
+	unsigned int max_comb_1st_len;	/* bytes of the write of such a */
+	unsigned int max_comb_2nd_len;	/* pair, and of its read */
+	int nostart;			/* I2C_M_NOSTART continuations */
+};
+
+extern int i2c_get_adapter_quirks(int file, struct i2c_adapter_quirks *quirks);
+
+/*
+ * Same as the I2C_RDWR ioctl, but messages are split to fit the adapter
+ * limits, in the largest legal chunks. Long reads become consecutive
+ * reads, long writes are continued with I2C_M_NOSTART, which must be
+ * supported. Messages go in as few ioctls as possible, so without
+ * combined transfer support, a stop replaces each repeated start.
+ * I2C_M_RECV_LEN messages are never split. Returns nmsgs or a negative
+ * errno value; on error, part of the transfer may have been done.
+ */
+extern __s32 i2c_transfer(int file, struct i2c_msg *msgs, int nmsgs);
+
+/* SMBus PEC (CRC-8) of count bytes, continuing from crc */
+extern __u8 i2c_smbus_pec(__u8 crc, const __u8 *buf, size_t count);
+
+#endif /* LIB_I2C_XFER_H */
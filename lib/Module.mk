@@ -13,13 +13,18 @@ LIB_DIR		:= lib
 LIB_CFLAGS	:= -Wstrict-prototypes -Wshadow -Wpointer-arith -Wcast-qual \
 		   -Wcast-align -Wwrite-strings -Wnested-externs -Winline \
 		   -W -Wundef -Wmissing-prototypes -Iinclude
+ifeq ($(USE_SDT),1)
+LIB_CFLAGS	+= -DHAVE_SYS_SDT_H
+endif
 
 # The main and minor version of the library
 # The library soname (major number) must be changed if and only if the
 # interface is changed in a backward incompatible way.  The interface is
-# defined by the public header files - in this case they are only smbus.h.
+# defined by the public header files - in this case they are smbus.h,
+# busses.h, monitor.h, trace.h, xfer.h, handle.h, stats.h and shmstats.h.
+# The minor number must be changed when the interface is extended.
 LIB_MAINVER	:= 0
-LIB_MINORVER	:= 2.0
+LIB_MINORVER	:= 3.0
 LIB_VER		:= $(LIB_MAINVER).$(LIB_MINORVER)
 
 # The shared and static library names
@@ -30,28 +35,35 @@ LIB_STLIBNAME	:= libi2c.a
 
 LIB_TARGETS	:= $(LIB_SHLIBNAME)
 LIB_LINKS	:= $(LIB_SHSONAME) $(LIB_SHBASENAME)
-LIB_OBJECTS	:= smbus.o busses.o
+LIB_OBJECTS	:= smbus.o busses.o monitor.o trace.o xfer.o quirks.o handle.o stats.o shmstats.o
 ifeq ($(BUILD_STATIC_LIB),1)
 LIB_TARGETS	+= $(LIB_STLIBNAME)
-LIB_OBJECTS	+= smbus.ao busses.ao
+LIB_OBJECTS	+= smbus.ao busses.ao monitor.ao trace.ao xfer.ao quirks.ao handle.ao stats.ao shmstats.ao
+endif
+
+# Programs linking with the library must depend on it, for parallel builds
+ifeq ($(USE_STATIC_LIB),1)
+LIB_DEPS	:= $(LIB_DIR)/$(LIB_STLIBNAME)
+else
+LIB_DEPS	:= $(LIB_DIR)/$(LIB_SHBASENAME)
 endif
 
 #
 # Libraries
 #
 
-$(LIB_DIR)/$(LIB_SHLIBNAME): $(LIB_DIR)/smbus.o $(LIB_DIR)/busses.o
+$(LIB_DIR)/$(LIB_SHLIBNAME): $(addprefix $(LIB_DIR)/,$(filter %.o,$(LIB_OBJECTS)))
 	$(CC) -shared $(LDFLAGS) -Wl,--version-script=$(LIB_DIR)/libi2c.map -Wl,-soname,$(LIB_SHSONAME) -o $@ $^ -lc
 
-$(LIB_DIR)/$(LIB_SHSONAME):
+$(LIB_DIR)/$(LIB_SHSONAME): $(LIB_DIR)/$(LIB_SHLIBNAME)
 	$(RM) $@
 	$(LN) $(LIB_SHLIBNAME) $@
 
-$(LIB_DIR)/$(LIB_SHBASENAME):
+$(LIB_DIR)/$(LIB_SHBASENAME): $(LIB_DIR)/$(LIB_SHLIBNAME)
 	$(RM) $@
 	$(LN) $(LIB_SHLIBNAME) $@
 
-$(LIB_DIR)/$(LIB_STLIBNAME): $(LIB_DIR)/smbus.ao $(LIB_DIR)/busses.ao
+$(LIB_DIR)/$(LIB_STLIBNAME): $(addprefix $(LIB_DIR)/,$(filter %.ao,$(LIB_OBJECTS)))
 	$(RM) $@
 	$(AR) rcvs $@ $^
 
@@ -61,18 +73,68 @@ $(LIB_DIR)/$(LIB_STLIBNAME): $(LIB_DIR)/smbus.ao $(LIB_DIR)/busses.ao
 # once again for the static library.
 #
 
-$(LIB_DIR)/smbus.o: $(LIB_DIR)/smbus.c $(INCLUDE_DIR)/i2c/smbus.h
+$(LIB_DIR)/smbus.o: $(LIB_DIR)/smbus.c $(INCLUDE_DIR)/i2c/smbus.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/smbus.ao: $(LIB_DIR)/smbus.c $(INCLUDE_DIR)/i2c/smbus.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/busses.o: $(LIB_DIR)/busses.c $(INCLUDE_DIR)/i2c/busses.h $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/busses.ao: $(LIB_DIR)/busses.c $(INCLUDE_DIR)/i2c/busses.h $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/monitor.o: $(LIB_DIR)/monitor.c $(INCLUDE_DIR)/i2c/monitor.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/monitor.ao: $(LIB_DIR)/monitor.c $(INCLUDE_DIR)/i2c/monitor.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/trace.o: $(LIB_DIR)/trace.c $(INCLUDE_DIR)/i2c/trace.h $(INCLUDE_DIR)/i2c/smbus.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/trace.ao: $(LIB_DIR)/trace.c $(INCLUDE_DIR)/i2c/trace.h $(INCLUDE_DIR)/i2c/smbus.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/xfer.o: $(LIB_DIR)/xfer.c $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
 	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
 
-$(LIB_DIR)/smbus.ao: $(LIB_DIR)/smbus.c $(INCLUDE_DIR)/i2c/smbus.h
+$(LIB_DIR)/xfer.ao: $(LIB_DIR)/xfer.c $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
 	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
 
-$(LIB_DIR)/busses.o: $(LIB_DIR)/busses.c $(INCLUDE_DIR)/i2c/busses.h
+$(LIB_DIR)/quirks.o: $(LIB_DIR)/quirks.c $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
 	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
 
-$(LIB_DIR)/busses.ao: $(LIB_DIR)/busses.c $(INCLUDE_DIR)/i2c/busses.h
+$(LIB_DIR)/quirks.ao: $(LIB_DIR)/quirks.c $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/handle.o: $(LIB_DIR)/handle.c $(INCLUDE_DIR)/i2c/handle.h $(INCLUDE_DIR)/i2c/smbus.h $(INCLUDE_DIR)/i2c/stats.h $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/handle.ao: $(LIB_DIR)/handle.c $(INCLUDE_DIR)/i2c/handle.h $(INCLUDE_DIR)/i2c/smbus.h $(INCLUDE_DIR)/i2c/stats.h $(INCLUDE_DIR)/i2c/xfer.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/stats.o: $(LIB_DIR)/stats.c $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/stats.ao: $(LIB_DIR)/stats.c $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/shmstats.o: $(LIB_DIR)/shmstats.c $(INCLUDE_DIR)/i2c/shmstats.h $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
+	$(CC) $(SOCFLAGS) $(LIB_CFLAGS) -c $< -o $@
+
+$(LIB_DIR)/shmstats.ao: $(LIB_DIR)/shmstats.c $(INCLUDE_DIR)/i2c/shmstats.h $(INCLUDE_DIR)/i2c/stats.h $(LIB_DIR)/internal.h
 	$(CC) $(CFLAGS) $(LIB_CFLAGS) -c $< -o $@
 
+#
+# Checks
+# The monitor only needs the C library, so it is built right in.
+#
+
+$(LIB_DIR)/monitor-check: $(LIB_DIR)/monitor-check.c $(LIB_DIR)/monitor.c $(INCLUDE_DIR)/i2c/monitor.h
+	$(CC) $(CFLAGS) $(LIB_CFLAGS) $(LDFLAGS) -o $@ $(filter %.c,$^)
+
 #
 # Commands
 #
@@ -82,8 +144,11 @@ all-lib: $(addprefix $(LIB_DIR)/,$(LIB_TARGETS) $(LIB_LINKS))
 strip-lib: $(addprefix $(LIB_DIR)/,$(LIB_TARGETS))
 	strip $(addprefix $(LIB_DIR)/,$(LIB_TARGETS))
 
+check-lib: $(LIB_DIR)/monitor-check
+	$(LIB_DIR)/monitor-check
+
 clean-lib:
-	$(RM) $(addprefix $(LIB_DIR)/,*.o *.ao $(LIB_TARGETS) $(LIB_LINKS))
+	$(RM) $(addprefix $(LIB_DIR)/,*.o *.ao $(LIB_TARGETS) $(LIB_LINKS) monitor-check)
 
 install-lib: $(addprefix $(LIB_DIR)/,$(LIB_TARGETS))
 	$(INSTALL_DIR) $(DESTDIR)$(libdir)
@@ -102,6 +167,8 @@ all: all-lib
 
 strip: strip-lib
 
+check: check-lib
+
 clean: clean-lib
 
 install: install-lib
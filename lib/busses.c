@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/sysmacros.h>
 #include <sys/ioctl.h>
 
 #include <string.h>
@@ -44,12 +45,72 @@
 #include <linux/i2c-dev.h>
 
 #include <i2c/busses.h>
+#include <i2c/stats.h>
+#include "internal.h"
+
+#ifdef HAVE_SYS_SDT_H
+/* USDT probe semaphores, see internal.h */
+I2C_PROBE_SEMAPHORE(bus_open);
+I2C_PROBE_SEMAPHORE(smbus_start);
+I2C_PROBE_SEMAPHORE(smbus_done);
+I2C_PROBE_SEMAPHORE(rdwr_start);
+I2C_PROBE_SEMAPHORE(rdwr_done);
+#endif
+
+/*
+ * Remember which slave address each file was set to, so that the
+ * transaction tracing code can tell who a transaction was for. Files
+ * beyond the table size are simply reported as unknown. Entries are
+ * stored off by one so that the zero-initialized table means unknown.
+ * Whether PEC is enabled is remembered the same way, for the wire time
+ * statistics.
+ */
+#define MAX_TRACKED_FILES	1024
+
+static unsigned short fd_addr[MAX_TRACKED_FILES];
+static unsigned char fd_pec[MAX_TRACKED_FILES];
+
+int i2c_fd_get_addr(int file)
+{
+	if (file < 0 || file >= MAX_TRACKED_FILES)
+		return -1;
+	return (int)fd_addr[file] - 1;
+}
+
+void i2c_fd_set_addr(int file, int addr)
+{
+	if (file >= 0 && file < MAX_TRACKED_FILES)
+		fd_addr[file] = addr + 1;
+}
+
+int i2c_fd_get_pec(int file)
+{
+	if (file < 0 || file >= MAX_TRACKED_FILES)
+		return 0;
+	return fd_pec[file];
+}
+
+void i2c_fd_set_pec(int file, int pec)
+{
+	if (file >= 0 && file < MAX_TRACKED_FILES)
+		fd_pec[file] = !!pec;
+}
+
+int i2c_fd_get_bus(int file)
+{
+	struct stat st;
+
+	if (fstat(file, &st) < 0 || !S_ISCHR(st.st_mode))
+		return -1;
+	return minor(st.st_rdev);
+}
 
 int i2c_open_i2c_dev(int i2cbus, char *filename, size_t size, int quiet) {
 	int file = -1;
 
 	snprintf(filename, size,"/dev/i2c-%d", i2cbus);
 	file = open(filename, O_RDWR);
+	I2C_PROBE2(bus_open, i2cbus, file < 0 ? -errno : file);
 
 	if (file < 0 && !quiet) {
 		if (errno == ENOENT) {
@@ -63,6 +124,14 @@ int i2c_open_i2c_dev(int i2cbus, char *filename, size_t size, int quiet) {
 		}
 	}
 
+	/* Don't blame this file for what a previous one with the same
+	   descriptor did, nor assume it is bound to the same address */
+	if (file >= 0) {
+		i2c_stats_reset(file);
+		i2c_fd_set_addr(file, -1);
+		i2c_fd_set_pec(file, 0);
+	}
+
 	return (file);
 }
 
@@ -85,6 +154,15 @@ int i2c_set_slave_addr(int file, int address, int force)
 			address, strerror(errno));
 		return -errno;
 	}
+	i2c_fd_set_addr(file, address);
+	return 0;
+}
+
+int i2c_set_pec(int file, int pec)
+{
+	if (ioctl(file, I2C_PEC, pec ? 1UL : 0UL) < 0)
+		return -errno;
+	i2c_fd_set_pec(file, pec);
 	return 0;
 }
 
@@ -0,0 +1,559 @@
+/*
+    handle.c - I2C adapter handles with per-adapter operation dispatch
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <i2c/handle.h>
+#include <i2c/smbus.h>
+#include <i2c/stats.h>
+#include <i2c/xfer.h>
+#include <sys/ioctl.h>
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "internal.h"
+
+struct i2c_handle {
+	int file;
+	int owned;
+	int probed;
+	unsigned long funcs;
+
+	/* Selected implementations, see select_ops() */
+	__s32 (*read_byte_data)(struct i2c_handle *, __u16, __u8);
+	__s32 (*write_byte_data)(struct i2c_handle *, __u16, __u8, __u8);
+	__s32 (*read_word_data)(struct i2c_handle *, __u16, __u8);
+	__s32 (*write_word_data)(struct i2c_handle *, __u16, __u8, __u16);
+	__s32 (*read_block_data)(struct i2c_handle *, __u16, __u8, __u8 *);
+	__s32 (*write_block_data)(struct i2c_handle *, __u16, __u8, __u8,
+				  const __u8 *);
+	__s32 (*read_bulk)(struct i2c_handle *, __u16, __u16, unsigned int,
+			   __u8 *, unsigned int);
+	const char *impl[I2C_OP_COUNT];
+};
+
+static const char *const op_names[I2C_OP_COUNT] = {
+	[I2C_OP_READ_BYTE_DATA]		= "read byte data",
+	[I2C_OP_WRITE_BYTE_DATA]	= "write byte data",
+	[I2C_OP_READ_WORD_DATA]		= "read word data",
+	[I2C_OP_WRITE_WORD_DATA]	= "write word data",
+	[I2C_OP_READ_BLOCK_DATA]	= "read block data",
+	[I2C_OP_WRITE_BLOCK_DATA]	= "write block data",
+	[I2C_OP_READ_BULK]		= "read bulk",
+};
+
+/*
+ * Plain I2C implementations, the address travels with each message
+ */
+
+static __s32 i2c_read_byte_data(struct i2c_handle *h, __u16 addr, __u8 command)
+{
+	return i2c_xfer_read_byte_data(h->file, addr, command);
+}
+
+static __s32 i2c_write_byte_data(struct i2c_handle *h, __u16 addr,
+				 __u8 command, __u8 value)
+{
+	return i2c_xfer_write_byte_data(h->file, addr, command, value);
+}
+
+static __s32 i2c_read_word_data(struct i2c_handle *h, __u16 addr, __u8 command)
+{
+	return i2c_xfer_read_word_data(h->file, addr, command);
+}
+
+static __s32 i2c_write_word_data(struct i2c_handle *h, __u16 addr,
+				 __u8 command, __u16 value)
+{
+	return i2c_xfer_write_word_data(h->file, addr, command, value);
+}
+
+static __s32 i2c_read_block_data(struct i2c_handle *h, __u16 addr,
+				 __u8 command, __u8 *values)
+{
+	return i2c_xfer_read_block_data(h->file, addr, command, values);
+}
+
+static __s32 i2c_write_block_data(struct i2c_handle *h, __u16 addr,
+				  __u8 command, __u8 length,
+				  const __u8 *values)
+{
+	return i2c_xfer_write_block_data(h->file, addr, command, length,
+					 values);
+}
+
+static __s32 i2c_read_bulk(struct i2c_handle *h, __u16 addr, __u16 flags,
+			   unsigned int offset, __u8 *values,
+			   unsigned int length)
+{
+	return i2c_xfer_read(h->file, addr, flags, offset, values, length);
+}
+
+/*
+ * SMBus implementations, the slave address is set when it changes
+ */
+
+static int smbus_bind(struct i2c_handle *h, __u16 addr)
+{
+	if (i2c_fd_get_addr(h->file) == addr)
+		return 0;
+	if (ioctl(h->file, I2C_SLAVE, addr) < 0)
+		return -errno;
+	i2c_fd_set_addr(h->file, addr);
+	return 0;
+}
+
+static __s32 smbus_read_byte_data(struct i2c_handle *h, __u16 addr,
+				  __u8 command)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_read_byte_data(h->file, command);
+}
+
+static __s32 smbus_write_byte_data(struct i2c_handle *h, __u16 addr,
+				   __u8 command, __u8 value)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_write_byte_data(h->file, command, value);
+}
+
+static __s32 smbus_read_word_data(struct i2c_handle *h, __u16 addr,
+				  __u8 command)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_read_word_data(h->file, command);
+}
+
+static __s32 smbus_write_word_data(struct i2c_handle *h, __u16 addr,
+				   __u8 command, __u16 value)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_write_word_data(h->file, command, value);
+}
+
+static __s32 smbus_read_block_data(struct i2c_handle *h, __u16 addr,
+				   __u8 command, __u8 *values)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_read_block_data(h->file, command, values);
+}
+
+static __s32 smbus_write_block_data(struct i2c_handle *h, __u16 addr,
+				    __u8 command, __u8 length,
+				    const __u8 *values)
+{
+	int err = smbus_bind(h, addr);
+
+	return err ? err : i2c_smbus_write_block_data(h->file, command,
+						      length, values);
+}
+
+static __s32 smbus_read_bulk_i2c_block(struct i2c_handle *h, __u16 addr,
+				       __u16 flags, unsigned int offset,
+				       __u8 *values, unsigned int length)
+{
+	unsigned int done = 0, chunk;
+	__s32 res;
+
+	if (flags & I2C_XFER_OFFSET16)
+		return -EOPNOTSUPP;
+	res = smbus_bind(h, addr);
+	if (res)
+		return res;
+
+	while (done < length) {
+		chunk = length - done;
+		if (chunk > I2C_SMBUS_BLOCK_MAX)
+			chunk = I2C_SMBUS_BLOCK_MAX;
+		res = i2c_smbus_read_i2c_block_data(h->file,
+						    (offset + done) & 0xff,
+						    chunk, values + done);
+		if (res <= 0)
+			return res < 0 ? res : -EIO;
+		done += res;
+	}
+
+	return done;
+}
+
+static __s32 smbus_read_bulk_byte_data(struct i2c_handle *h, __u16 addr,
+				       __u16 flags, unsigned int offset,
+				       __u8 *values, unsigned int length)
+{
+	unsigned int i;
+	__s32 res;
+
+	if (flags & I2C_XFER_OFFSET16)
+		return -EOPNOTSUPP;
+	res = smbus_bind(h, addr);
+	if (res)
+		return res;
+
+	for (i = 0; i < length; i++) {
+		res = i2c_smbus_read_byte_data(h->file, (offset + i) & 0xff);
+		if (res < 0)
+			return res;
+		values[i] = res;
+	}
+
+	return length;
+}
+
+/*
+ * Operations the adapter can't do
+ */
+
+#define UNUSED __attribute__ ((unused))
+
+static __s32 none_read_data(struct i2c_handle *h UNUSED, __u16 addr UNUSED,
+			    __u8 command UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+static __s32 none_write_byte_data(struct i2c_handle *h UNUSED,
+				  __u16 addr UNUSED, __u8 command UNUSED,
+				  __u8 value UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+static __s32 none_write_word_data(struct i2c_handle *h UNUSED,
+				  __u16 addr UNUSED, __u8 command UNUSED,
+				  __u16 value UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+static __s32 none_read_block_data(struct i2c_handle *h UNUSED,
+				  __u16 addr UNUSED, __u8 command UNUSED,
+				  __u8 *values UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+static __s32 none_write_block_data(struct i2c_handle *h UNUSED,
+				   __u16 addr UNUSED, __u8 command UNUSED,
+				   __u8 length UNUSED,
+				   const __u8 *values UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+static __s32 none_read_bulk(struct i2c_handle *h UNUSED, __u16 addr UNUSED,
+			    __u16 flags UNUSED, unsigned int offset UNUSED,
+			    __u8 *values UNUSED, unsigned int length UNUSED)
+{
+	return -EOPNOTSUPP;
+}
+
+/*
+ * Selection
+ */
+
+#define SELECT(h, op, field, fn, name) \
+	do { (h)->field = (fn); (h)->impl[op] = (name); } while (0)
+
+/*
+ * Pick, for each operation, the first implementation the adapter can do:
+ * plain I2C if it does combined transfers (one ioctl, no address switch),
+ * then native SMBus, then plain I2C split by i2c_transfer().
+ *
+ * Probing the adapter limits takes a few dozen transfers, so until an
+ * operation fails with -EOPNOTSUPP, I2C adapters are assumed to have
+ * none, see reselect_ops().
+ */
+static void select_ops(struct i2c_handle *h)
+{
+	struct i2c_adapter_quirks quirks;
+	unsigned long funcs = h->funcs;
+	int i2c = 0, fast_i2c = 0;
+
+	if (funcs & I2C_FUNC_I2C) {
+		if (!h->probed) {
+			i2c = fast_i2c = 1;
+		} else if (!i2c_get_adapter_quirks(h->file, &quirks)) {
+			i2c = 1;
+			fast_i2c = quirks.combined;
+		}
+	}
+
+	if (fast_i2c || (i2c && !(funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)))
+		SELECT(h, I2C_OP_READ_BYTE_DATA, read_byte_data,
+		       i2c_read_byte_data, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)
+		SELECT(h, I2C_OP_READ_BYTE_DATA, read_byte_data,
+		       smbus_read_byte_data, "smbus");
+	else
+		SELECT(h, I2C_OP_READ_BYTE_DATA, read_byte_data,
+		       none_read_data, NULL);
+
+	if (fast_i2c || (i2c && !(funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA)))
+		SELECT(h, I2C_OP_WRITE_BYTE_DATA, write_byte_data,
+		       i2c_write_byte_data, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA)
+		SELECT(h, I2C_OP_WRITE_BYTE_DATA, write_byte_data,
+		       smbus_write_byte_data, "smbus");
+	else
+		SELECT(h, I2C_OP_WRITE_BYTE_DATA, write_byte_data,
+		       none_write_byte_data, NULL);
+
+	if (fast_i2c || (i2c && !(funcs & I2C_FUNC_SMBUS_READ_WORD_DATA)))
+		SELECT(h, I2C_OP_READ_WORD_DATA, read_word_data,
+		       i2c_read_word_data, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_READ_WORD_DATA)
+		SELECT(h, I2C_OP_READ_WORD_DATA, read_word_data,
+		       smbus_read_word_data, "smbus");
+	else
+		SELECT(h, I2C_OP_READ_WORD_DATA, read_word_data,
+		       none_read_data, NULL);
+
+	if (fast_i2c || (i2c && !(funcs & I2C_FUNC_SMBUS_WRITE_WORD_DATA)))
+		SELECT(h, I2C_OP_WRITE_WORD_DATA, write_word_data,
+		       i2c_write_word_data, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_WRITE_WORD_DATA)
+		SELECT(h, I2C_OP_WRITE_WORD_DATA, write_word_data,
+		       smbus_write_word_data, "smbus");
+	else
+		SELECT(h, I2C_OP_WRITE_WORD_DATA, write_word_data,
+		       none_write_word_data, NULL);
+
+	/* Plain I2C block reads need the adapter to take the count too */
+	if (!(funcs & I2C_FUNC_SMBUS_READ_BLOCK_DATA))
+		SELECT(h, I2C_OP_READ_BLOCK_DATA, read_block_data,
+		       none_read_block_data, NULL);
+	else if (fast_i2c)
+		SELECT(h, I2C_OP_READ_BLOCK_DATA, read_block_data,
+		       i2c_read_block_data, "i2c");
+	else
+		SELECT(h, I2C_OP_READ_BLOCK_DATA, read_block_data,
+		       smbus_read_block_data, "smbus");
+
+	if (fast_i2c || (i2c && !(funcs & I2C_FUNC_SMBUS_WRITE_BLOCK_DATA)))
+		SELECT(h, I2C_OP_WRITE_BLOCK_DATA, write_block_data,
+		       i2c_write_block_data, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_WRITE_BLOCK_DATA)
+		SELECT(h, I2C_OP_WRITE_BLOCK_DATA, write_block_data,
+		       smbus_write_block_data, "smbus");
+	else
+		SELECT(h, I2C_OP_WRITE_BLOCK_DATA, write_block_data,
+		       none_write_block_data, NULL);
+
+	if (fast_i2c)
+		SELECT(h, I2C_OP_READ_BULK, read_bulk, i2c_read_bulk, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_READ_I2C_BLOCK)
+		SELECT(h, I2C_OP_READ_BULK, read_bulk,
+		       smbus_read_bulk_i2c_block, "smbus i2c block");
+	else if (i2c)
+		SELECT(h, I2C_OP_READ_BULK, read_bulk, i2c_read_bulk, "i2c");
+	else if (funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)
+		SELECT(h, I2C_OP_READ_BULK, read_bulk,
+		       smbus_read_bulk_byte_data, "smbus byte data");
+	else
+		SELECT(h, I2C_OP_READ_BULK, read_bulk, none_read_bulk, NULL);
+}
+
+/*
+ * Called when an operation returned res: if the adapter refused it and
+ * its limits weren't looked at yet, select again knowing them, and tell
+ * the caller to retry. This only happens once per handle.
+ */
+static int reselect_ops(struct i2c_handle *h, __s32 res)
+{
+	if (res != -EOPNOTSUPP || h->probed || !(h->funcs & I2C_FUNC_I2C))
+		return 0;
+	h->probed = 1;
+	select_ops(h);
+	return 1;
+}
+
+/*
+ * Handles
+ */
+
+struct i2c_handle *i2c_handle_new(int file)
+{
+	struct i2c_handle *h;
+
+	h = calloc(1, sizeof(*h));
+	if (!h)
+		return NULL;
+
+	h->file = file;
+	if (ioctl(file, I2C_FUNCS, &h->funcs) < 0) {
+		free(h);
+		return NULL;
+	}
+	/* The descriptor number may have been used by a closed file */
+	i2c_fd_set_addr(file, -1);
+	select_ops(h);
+
+	return h;
+}
+
+struct i2c_handle *i2c_handle_open(int i2cbus)
+{
+	struct i2c_handle *h;
+	char filename[20];
+	int file, err;
+
+	snprintf(filename, sizeof(filename), "/dev/i2c-%d", i2cbus);
+	file = open(filename, O_RDWR);
+	I2C_PROBE2(bus_open, i2cbus, file < 0 ? -errno : file);
+	if (file < 0)
+		return NULL;
+	i2c_stats_reset(file);
+	i2c_fd_set_pec(file, 0);
+
+	h = i2c_handle_new(file);
+	if (!h) {
+		err = errno;
+		close(file);
+		errno = err;
+		return NULL;
+	}
+	h->owned = 1;
+
+	return h;
+}
+
+void i2c_handle_close(struct i2c_handle *handle)
+{
+	if (!handle)
+		return;
+	i2c_fd_set_addr(handle->file, -1);
+	if (handle->owned)
+		close(handle->file);
+	free(handle);
+}
+
+int i2c_handle_file(const struct i2c_handle *handle)
+{
+	return handle->file;
+}
+
+unsigned long i2c_handle_functionality(const struct i2c_handle *handle)
+{
+	return handle->funcs;
+}
+
+const char *i2c_handle_impl(const struct i2c_handle *handle,
+			    enum i2c_handle_op op)
+{
+	if (op < 0 || op >= I2C_OP_COUNT)
+		return NULL;
+	return handle->impl[op];
+}
+
+const char *i2c_handle_op_name(enum i2c_handle_op op)
+{
+	if (op < 0 || op >= I2C_OP_COUNT)
+		return NULL;
+	return op_names[op];
+}
+
+/*
+ * Operations
+ */
+
+__s32 i2c_handle_read_byte_data(struct i2c_handle *handle, __u16 addr,
+				__u8 command)
+{
+	__s32 res = handle->read_byte_data(handle, addr, command);
+
+	if (reselect_ops(handle, res))
+		res = handle->read_byte_data(handle, addr, command);
+	return res;
+}
+
+__s32 i2c_handle_write_byte_data(struct i2c_handle *handle, __u16 addr,
+				 __u8 command, __u8 value)
+{
+	__s32 res = handle->write_byte_data(handle, addr, command, value);
+
+	if (reselect_ops(handle, res))
+		res = handle->write_byte_data(handle, addr, command, value);
+	return res;
+}
+
+__s32 i2c_handle_read_word_data(struct i2c_handle *handle, __u16 addr,
+				__u8 command)
+{
+	__s32 res = handle->read_word_data(handle, addr, command);
+
+	if (reselect_ops(handle, res))
+		res = handle->read_word_data(handle, addr, command);
+	return res;
+}
+
+__s32 i2c_handle_write_word_data(struct i2c_handle *handle, __u16 addr,
+				 __u8 command, __u16 value)
+{
+	__s32 res = handle->write_word_data(handle, addr, command, value);
+
+	if (reselect_ops(handle, res))
+		res = handle->write_word_data(handle, addr, command, value);
+	return res;
+}
+
+__s32 i2c_handle_read_block_data(struct i2c_handle *handle, __u16 addr,
+				 __u8 command, __u8 *values)
+{
+	__s32 res = handle->read_block_data(handle, addr, command, values);
+
+	if (reselect_ops(handle, res))
+		res = handle->read_block_data(handle, addr, command, values);
+	return res;
+}
+
+__s32 i2c_handle_write_block_data(struct i2c_handle *handle, __u16 addr,
+				  __u8 command, __u8 length,
+				  const __u8 *values)
+{
+	__s32 res = handle->write_block_data(handle, addr, command, length,
+					     values);
+
+	if (reselect_ops(handle, res))
+		res = handle->write_block_data(handle, addr, command, length,
+					       values);
+	return res;
+}
+
+__s32 i2c_handle_read_bulk(struct i2c_handle *handle, __u16 addr,
+			   __u16 flags, unsigned int offset, __u8 *values,
+			   unsigned int length)
+{
+	__s32 res = handle->read_bulk(handle, addr, flags, offset, values,
+				      length);
+
+	if (reselect_ops(handle, res))
+		res = handle->read_bulk(handle, addr, flags, offset, values,
+					length);
+	return res;
+}
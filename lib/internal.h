@@ -0,0 +1,148 @@
+/*
+    internal.h - libi2c internal helpers, not part of the API
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef LIB_I2C_INTERNAL_H
+#define LIB_I2C_INTERNAL_H
+
+#include <time.h>
+#include <linux/types.h>
+#include <linux/i2c.h>
+
+/* Slave address last set on a file by i2c_set_slave_addr(), or -1 */
+extern int i2c_fd_get_addr(int file);
+extern void i2c_fd_set_addr(int file, int addr);
+
+/* Whether PEC was last enabled on a file by i2c_set_pec() */
+extern int i2c_fd_get_pec(int file);
+extern void i2c_fd_set_pec(int file, int pec);
+
+/* i2c-dev bus number of an open file, or -1 */
+extern int i2c_fd_get_bus(int file);
+
+/* Transaction recording and replay, see trace.c */
+#define I2C_TRACE_RECORD	0x01
+#define I2C_TRACE_REPLAY	0x02
+#define I2C_TRACE_STATS		0x04
+#define I2C_TRACE_SHM		0x08
+#define I2C_TRACE_TIMELINE	0x10
+
+/* Any kind of transaction logging or counting */
+#define I2C_TRACE_LOG		(I2C_TRACE_RECORD | I2C_TRACE_TIMELINE)
+#define I2C_TRACE_COUNT		(I2C_TRACE_STATS | I2C_TRACE_SHM)
+
+extern int i2c_trace_flags;
+
+/* addr is the slave address of the transaction, or -1 if unknown */
+extern __s32 i2c_trace_replay(int file, int addr, char read_write,
+			      __u8 command, int size,
+			      union i2c_smbus_data *data);
+extern void i2c_trace_record(int file, int addr,
+			     const struct timespec *start, char read_write,
+			     __u8 command, int size,
+			     const union i2c_smbus_data *data, __s32 result);
+/* Timeline only, result is the I2C_RDWR ioctl return value */
+extern void i2c_trace_rdwr(int file, const struct timespec *start,
+			   const struct i2c_msg *msgs, int nmsgs,
+			   __s32 result);
+
+/* Number of meaningful bytes in data after a transaction */
+extern int i2c_smbus_data_len(char read_write, int size,
+			      const union i2c_smbus_data *data, __s32 result);
+
+/*
+ * Statistics, see stats.c. Bits successfully sent on the wire add up in
+ * i2c_wire_bits while counting, until the transaction they belong to is
+ * accounted for.
+ */
+extern void i2c_stats_account(int file, int addr,
+			      const struct timespec *start, unsigned int bytes,
+			      __s32 result, unsigned int retries);
+extern __thread unsigned int i2c_wire_bits;
+extern unsigned int i2c_msgs_wire_bits(const struct i2c_msg *msgs,
+				       int nmsgs);
+extern unsigned int i2c_smbus_wire_bits(char read_write, int size,
+					const union i2c_smbus_data *data,
+					int pec);
+
+/* Shared memory statistics, see shmstats.c; bus is -1 if unknown */
+extern void i2c_shm_account(int bus, int addr, __u64 ns, int bucket,
+			    unsigned int bytes, unsigned int wire_bits,
+			    __s32 result);
+
+/* i2c_transfer() without statistics */
+extern __s32 i2c_transfer_split(int file, struct i2c_msg *msgs, int nmsgs);
+
+/* I2C_RDWR ioctl, with probes; returns 0 or a negative errno value */
+extern int i2c_rdwr(int file, struct i2c_msg *msgs, int nmsgs);
+
+/*
+ * USDT probes of provider libi2c, for perf, bpftrace or SystemTap:
+ *
+ *   bus_open(bus, fd)				fd is -errno on failure
+ *   smbus_start(fd, addr, read_write, command, size)
+ *   smbus_done(fd, addr, read_write, command, size, result)
+ *   rdwr_start(fd, addr, nmsgs, len)
+ *   rdwr_done(fd, addr, nmsgs, result)
+ *
+ * addr is -1 if unknown. For I2C_RDWR it is the address of the first
+ * message, and len the total length of all messages. Probes are only
+ * built if <sys/sdt.h> was found (USE_SDT). Each has a semaphore, which
+ * the tracer increments while attached, so that the arguments are only
+ * computed when someone is listening. The semaphores are defined in
+ * busses.c.
+ */
+#ifdef HAVE_SYS_SDT_H
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#define I2C_PROBE_SEMAPHORE(name) \
+	unsigned short libi2c_##name##_semaphore \
+	__attribute__ ((section (".probes"), visibility ("hidden")))
+extern I2C_PROBE_SEMAPHORE(bus_open);
+extern I2C_PROBE_SEMAPHORE(smbus_start);
+extern I2C_PROBE_SEMAPHORE(smbus_done);
+extern I2C_PROBE_SEMAPHORE(rdwr_start);
+extern I2C_PROBE_SEMAPHORE(rdwr_done);
+#define I2C_PROBE_ENABLED(name) \
+	__builtin_expect(libi2c_##name##_semaphore, 0)
+#define I2C_PROBE2(name, a1, a2) do { \
+	if (I2C_PROBE_ENABLED(name)) \
+		STAP_PROBE2(libi2c, name, a1, a2); \
+} while (0)
+#define I2C_PROBE4(name, a1, a2, a3, a4) do { \
+	if (I2C_PROBE_ENABLED(name)) \
+		STAP_PROBE4(libi2c, name, a1, a2, a3, a4); \
+} while (0)
+#define I2C_PROBE5(name, a1, a2, a3, a4, a5) do { \
+	if (I2C_PROBE_ENABLED(name)) \
+		STAP_PROBE5(libi2c, name, a1, a2, a3, a4, a5); \
+} while (0)
+#define I2C_PROBE6(name, a1, a2, a3, a4, a5, a6) do { \
+	if (I2C_PROBE_ENABLED(name)) \
+		STAP_PROBE6(libi2c, name, a1, a2, a3, a4, a5, a6); \
+} while (0)
+#else
+#define I2C_PROBE2(name, a1, a2)			do { } while (0)
+#define I2C_PROBE4(name, a1, a2, a3, a4)		do { } while (0)
+#define I2C_PROBE5(name, a1, a2, a3, a4, a5)		do { } while (0)
+#define I2C_PROBE6(name, a1, a2, a3, a4, a5, a6)	do { } while (0)
+#endif
+
+#endif /* LIB_I2C_INTERNAL_H */
@@ -0,0 +1,161 @@
+/*
+    monitor-check.c - Check of the I2C adapter hotplug notifications
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+/*
+ * Adapters are added and removed in a fake sysfs tree under a temporary
+ * directory, and the events reported by the monitor are compared with
+ * what was done. Exits 0 if all events were as expected, 1 otherwise.
+ */
+
+#include <sys/stat.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <i2c/monitor.h>
+
+static char root[] = "/tmp/i2c-monitor.XXXXXX";
+static char dir[64];
+static int failed;
+
+/* Adapter directories are moved into place with their name file */
+static void add_adapter(int nr, const char *name)
+{
+	char tmp[64], path[PATH_MAX];
+	FILE *f;
+
+	snprintf(tmp, sizeof(tmp), "%s/i2c-%d", root, nr);
+	snprintf(path, sizeof(path), "%s/name", tmp);
+	if (mkdir(tmp, 0755) < 0 || !(f = fopen(path, "w"))) {
+		perror(tmp);
+		exit(1);
+	}
+	fprintf(f, "%s\n", name);
+	fclose(f);
+
+	snprintf(path, sizeof(path), "%s/i2c-%d", dir, nr);
+	if (rename(tmp, path) < 0) {
+		perror(path);
+		exit(1);
+	}
+}
+
+static void remove_adapter(int nr)
+{
+	char path[PATH_MAX];
+
+	snprintf(path, sizeof(path), "%s/i2c-%d/name", dir, nr);
+	unlink(path);
+	snprintf(path, sizeof(path), "%s/i2c-%d", dir, nr);
+	if (rmdir(path) < 0) {
+		perror(path);
+		exit(1);
+	}
+}
+
+static void expect(struct i2c_monitor *mon, int type, int nr,
+		   const char *name)
+{
+	struct i2c_adapter_event ev;
+	struct pollfd pfd;
+	int res;
+
+	pfd.fd = i2c_monitor_get_fd(mon);
+	pfd.events = POLLIN;
+
+	while ((res = i2c_monitor_read_event(mon, &ev)) == 0) {
+		if (poll(&pfd, 1, 1000) <= 0)
+			break;
+	}
+	if (res < 0) {
+		fprintf(stderr, "Error: Reading event: %s\n", strerror(-res));
+		failed = 1;
+	} else if (res == 0) {
+		fprintf(stderr, "Error: No event, expected %s of i2c-%d\n",
+			type == I2C_ADAPTER_ADD ? "add" : "remove", nr);
+		failed = 1;
+	} else if (ev.type != type || ev.nr != nr || strcmp(ev.name, name)) {
+		fprintf(stderr, "Error: Got %s of i2c-%d (%s), expected %s "
+			"of i2c-%d (%s)\n",
+			ev.type == I2C_ADAPTER_ADD ? "add" : "remove", ev.nr,
+			ev.name, type == I2C_ADAPTER_ADD ? "add" : "remove",
+			nr, name);
+		failed = 1;
+	}
+}
+
+static void expect_none(struct i2c_monitor *mon)
+{
+	struct i2c_adapter_event ev;
+
+	if (i2c_monitor_read_event(mon, &ev) != 0) {
+		fprintf(stderr, "Error: Unexpected event\n");
+		failed = 1;
+	}
+}
+
+int main(void)
+{
+	struct i2c_monitor *mon;
+	char path[PATH_MAX];
+
+	if (!mkdtemp(root)) {
+		perror(root);
+		exit(1);
+	}
+	snprintf(path, sizeof(path), "%s/class", root);
+	snprintf(dir, sizeof(dir), "%s/class/i2c-dev", root);
+	if (mkdir(path, 0755) < 0 || mkdir(dir, 0755) < 0) {
+		perror(dir);
+		exit(1);
+	}
+
+	add_adapter(3, "adapter 3");
+	mon = i2c_monitor_open(root, I2C_MONITOR_INITIAL);
+	if (!mon) {
+		perror("i2c_monitor_open");
+		exit(1);
+	}
+	expect(mon, I2C_ADAPTER_ADD, 3, "adapter 3");
+	expect_none(mon);
+
+	add_adapter(5, "adapter 5");
+	expect(mon, I2C_ADAPTER_ADD, 5, "adapter 5");
+	remove_adapter(3);
+	expect(mon, I2C_ADAPTER_REMOVE, 3, "adapter 3");
+	expect_none(mon);
+
+	/* The last adapters go away along with the class directory */
+	remove_adapter(5);
+	rmdir(dir);
+	expect(mon, I2C_ADAPTER_REMOVE, 5, "adapter 5");
+	expect_none(mon);
+
+	i2c_monitor_close(mon);
+	rmdir(path);
+	rmdir(root);
+
+	if (!failed)
+		printf("monitor: OK\n");
+	exit(failed);
+}
@@ -0,0 +1,318 @@
+/*
+    monitor.c - I2C adapter hotplug notifications
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+/* For memmem */
+#define _GNU_SOURCE 1
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/inotify.h>
+#include <linux/netlink.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <i2c/monitor.h>
+
+/*
+ * Whatever the notification source, we only use it as a hint that
+ * something changed, and rescan the class directory to find out what.
+ * Listing a directory is cheap, and it lets us report removals with
+ * the adapter name, which isn't available from sysfs any longer.
+ */
+
+struct monitor_adap {
+	int nr;
+	int seen;
+	char name[I2C_ADAPTER_NAME_MAX];
+};
+
+struct i2c_monitor {
+	int fd;
+	int use_uevent;
+	char dir[PATH_MAX];
+
+	/* Known adapters */
+	struct monitor_adap *adaps;
+	int nr_adaps, max_adaps;
+
+	/* Pending events, consumed from head */
+	struct i2c_adapter_event *events;
+	int head, nr_events, max_events;
+};
+
+static int monitor_queue(struct i2c_monitor *mon, int type,
+			 const struct monitor_adap *adap)
+{
+	struct i2c_adapter_event *ev;
+
+	if (mon->head == mon->nr_events)
+		mon->head = mon->nr_events = 0;
+
+	if (mon->nr_events == mon->max_events) {
+		int max = mon->max_events ? 2 * mon->max_events : 8;
+
+		ev = realloc(mon->events, max * sizeof(*ev));
+		if (!ev)
+			return -ENOMEM;
+		mon->events = ev;
+		mon->max_events = max;
+	}
+
+	ev = &mon->events[mon->nr_events++];
+	ev->type = type;
+	ev->nr = adap->nr;
+	memcpy(ev->name, adap->name, sizeof(ev->name));
+	return 0;
+}
+
+/* Read the adapter name, same locations as gather_i2c_busses() */
+static void monitor_get_name(const struct i2c_monitor *mon, const char *entry,
+			     char *name, size_t size)
+{
+	char path[PATH_MAX];
+	FILE *f;
+	char *p;
+
+	name[0] = '\0';
+
+	if (snprintf(path, sizeof(path), "%s/%s/name", mon->dir,
+		     entry) >= (int)sizeof(path))
+		return;
+	f = fopen(path, "r");
+	if (!f) {
+		if (snprintf(path, sizeof(path), "%s/%s/device/name", mon->dir,
+			     entry) >= (int)sizeof(path))
+			return;
+		f = fopen(path, "r");
+	}
+	if (!f)
+		return;
+	if (fgets(name, size, f) && (p = strchr(name, '\n')))
+		*p = '\0';
+	fclose(f);
+}
+
+static int monitor_scan(struct i2c_monitor *mon)
+{
+	struct dirent *de;
+	DIR *dir;
+	int i, nr, err = 0;
+
+	/* The directory goes away with the last adapter, or i2c-dev */
+	dir = opendir(mon->dir);
+	if (!dir && errno != ENOENT)
+		return -errno;
+
+	for (i = 0; i < mon->nr_adaps; i++)
+		mon->adaps[i].seen = 0;
+
+	while (dir && (de = readdir(dir)) != NULL) {
+		struct monitor_adap *adap;
+
+		if (sscanf(de->d_name, "i2c-%d", &nr) != 1)
+			continue;
+
+		for (i = 0; i < mon->nr_adaps; i++)
+			if (mon->adaps[i].nr == nr)
+				break;
+		if (i < mon->nr_adaps) {
+			mon->adaps[i].seen = 1;
+			continue;
+		}
+
+		if (mon->nr_adaps == mon->max_adaps) {
+			int max = mon->max_adaps ? 2 * mon->max_adaps : 8;
+
+			adap = realloc(mon->adaps, max * sizeof(*adap));
+			if (!adap) {
+				err = -ENOMEM;
+				break;
+			}
+			mon->adaps = adap;
+			mon->max_adaps = max;
+		}
+
+		adap = &mon->adaps[mon->nr_adaps++];
+		adap->nr = nr;
+		adap->seen = 1;
+		monitor_get_name(mon, de->d_name, adap->name,
+				 sizeof(adap->name));
+		err = monitor_queue(mon, I2C_ADAPTER_ADD, adap);
+		if (err)
+			break;
+	}
+	if (dir)
+		closedir(dir);
+	if (err)
+		return err;
+
+	/* Whatever wasn't seen is gone */
+	for (i = 0; i < mon->nr_adaps; ) {
+		if (mon->adaps[i].seen) {
+			i++;
+			continue;
+		}
+		err = monitor_queue(mon, I2C_ADAPTER_REMOVE, &mon->adaps[i]);
+		if (err)
+			return err;
+		mon->adaps[i] = mon->adaps[--mon->nr_adaps];
+	}
+
+	return 0;
+}
+
+static int monitor_open_uevent(void)
+{
+	struct sockaddr_nl addr;
+	int fd;
+
+	fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+		    NETLINK_KOBJECT_UEVENT);
+	if (fd < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = 1;	/* kernel uevents */
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+struct i2c_monitor *i2c_monitor_open(const char *sysfs_root, int flags)
+{
+	struct i2c_monitor *mon;
+	int err;
+
+	mon = calloc(1, sizeof(*mon));
+	if (!mon)
+		return NULL;
+
+	mon->use_uevent = sysfs_root == NULL;
+	snprintf(mon->dir, sizeof(mon->dir), "%s/class/i2c-dev",
+		 sysfs_root ? sysfs_root : "/sys");
+
+	if (mon->use_uevent) {
+		mon->fd = monitor_open_uevent();
+	} else {
+		mon->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (mon->fd >= 0
+		 && inotify_add_watch(mon->fd, mon->dir,
+				      IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+				      IN_MOVED_TO) < 0) {
+			err = errno;
+			close(mon->fd);
+			mon->fd = -1;
+			errno = err;
+		}
+	}
+	if (mon->fd < 0) {
+		free(mon);
+		return NULL;
+	}
+
+	/* Take the initial snapshot */
+	err = monitor_scan(mon);
+	if (err) {
+		i2c_monitor_close(mon);
+		errno = -err;
+		return NULL;
+	}
+	if (!(flags & I2C_MONITOR_INITIAL))
+		mon->head = mon->nr_events = 0;
+
+	return mon;
+}
+
+void i2c_monitor_close(struct i2c_monitor *mon)
+{
+	if (!mon)
+		return;
+	close(mon->fd);
+	free(mon->adaps);
+	free(mon->events);
+	free(mon);
+}
+
+int i2c_monitor_get_fd(const struct i2c_monitor *mon)
+{
+	return mon->fd;
+}
+
+/* Drain the notification fd, return 1 if a rescan is needed */
+static int monitor_drain(struct i2c_monitor *mon)
+{
+	char buf[4096] __attribute__ ((aligned(8)));
+	ssize_t len;
+	int changed = 0;
+
+	while ((len = read(mon->fd, buf, sizeof(buf) - 1)) > 0) {
+		if (!mon->use_uevent) {
+			changed = 1;
+			continue;
+		}
+
+		/* NUL-separated KEY=value pairs after an action@path header */
+		buf[len] = '\0';
+		if (memmem(buf, len, "\0SUBSYSTEM=i2c-dev\0",
+			   sizeof("\0SUBSYSTEM=i2c-dev\0") - 1))
+			changed = 1;
+	}
+	if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK
+	 && errno != ENOBUFS)
+		return -errno;
+
+	/* On overflow we lost events, so rescan in any case */
+	if (len < 0 && errno == ENOBUFS)
+		changed = 1;
+
+	return changed;
+}
+
+int i2c_monitor_read_event(struct i2c_monitor *mon,
+			   struct i2c_adapter_event *event)
+{
+	int err;
+
+	if (mon->head == mon->nr_events) {
+		err = monitor_drain(mon);
+		if (err <= 0)
+			return err;
+		err = monitor_scan(mon);
+		if (err)
+			return err;
+		if (mon->head == mon->nr_events)
+			return 0;
+	}
+
+	*event = mon->events[mon->head++];
+	return 1;
+}
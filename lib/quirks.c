@@ -0,0 +1,300 @@
+/*
+    quirks.c - I2C adapter transfer limits, and transfers fitting them
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <i2c/xfer.h>
+#include <sys/ioctl.h>
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "internal.h"
+
+/* Compatibility defines */
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS	42
+#endif
+#ifndef I2C_M_RECV_LEN
+#define I2C_M_RECV_LEN	0x0400
+#endif
+#ifndef I2C_M_NOSTART
+#define I2C_M_NOSTART	0x4000
+#endif
+#ifndef I2C_FUNC_NOSTART
+#define I2C_FUNC_NOSTART	0x00000010
+#endif
+
+/*
+ * Limits are probed with transfers to a reserved address, which no
+ * device acknowledges. The i2c core checks the adapter quirks before
+ * touching the bus, so a transfer the adapter can't do fails with
+ * -EOPNOTSUPP (or -EINVAL from drivers doing their own checks), while
+ * any other outcome, typically a NACK, means the transfer was legal.
+ * At worst, an address byte goes on the wire.
+ */
+#define PROBE_ADDR		0x7f
+
+/*
+ * Probed limits, cached per adapter number for the life of the process.
+ * Adapters beyond the table size are probed on every request. A
+ * concurrent probe of the same adapter only does the work twice.
+ */
+#define MAX_CACHED_ADAPTERS	1024
+
+static struct {
+	struct i2c_adapter_quirks quirks;
+	int valid;
+} quirks_cache[MAX_CACHED_ADAPTERS];
+
+static int probe_rejected(int file, struct i2c_msg *msgs, int nmsgs)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = nmsgs;
+	if (ioctl(file, I2C_RDWR, &rdwr) >= 0)
+		return 0;
+	return errno == EOPNOTSUPP || errno == EINVAL;
+}
+
+/* Largest length in [1, max] of msgs[index] the adapter accepts */
+static unsigned int probe_len(int file, struct i2c_msg *msgs, int nmsgs,
+			      int index, unsigned int max)
+{
+	unsigned int lo = 1, hi = max, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		msgs[index].len = mid;
+		if (probe_rejected(file, msgs, nmsgs))
+			hi = mid - 1;
+		else
+			lo = mid;
+	}
+	msgs[index].len = 1;
+	return lo;
+}
+
+/* Largest number of 1-byte read messages in one ioctl */
+static unsigned int probe_msgs(int file, __u8 *buf)
+{
+	struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	unsigned int lo = 1, hi = I2C_RDWR_IOCTL_MAX_MSGS, mid, i;
+
+	for (i = 0; i < I2C_RDWR_IOCTL_MAX_MSGS; i++) {
+		msgs[i].addr = PROBE_ADDR;
+		msgs[i].flags = I2C_M_RD;
+		msgs[i].len = 1;
+		msgs[i].buf = buf;
+	}
+
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (probe_rejected(file, msgs, mid))
+			hi = mid - 1;
+		else
+			lo = mid;
+	}
+	return lo;
+}
+
+static int probe_quirks(int file, struct i2c_adapter_quirks *q)
+{
+	struct i2c_msg msgs[2];
+	unsigned long funcs;
+	__u8 *buf;
+
+	if (ioctl(file, I2C_FUNCS, &funcs) < 0)
+		return -errno;
+	if (!(funcs & I2C_FUNC_I2C))
+		return -EOPNOTSUPP;
+
+	buf = calloc(1, I2C_XFER_MSG_MAX);
+	if (!buf)
+		return -ENOMEM;
+
+	msgs[0].addr = PROBE_ADDR;
+	msgs[0].flags = 0;
+	msgs[0].len = 1;
+	msgs[0].buf = buf;
+	msgs[1].addr = PROBE_ADDR;
+	msgs[1].flags = I2C_M_RD;
+	msgs[1].len = 1;
+	msgs[1].buf = buf;
+
+	q->max_write_len = probe_len(file, &msgs[0], 1, 0, I2C_XFER_MSG_MAX);
+	q->max_read_len = probe_len(file, &msgs[1], 1, 0, I2C_XFER_MSG_MAX);
+	q->max_msgs = probe_msgs(file, buf);
+	q->nostart = !!(funcs & I2C_FUNC_NOSTART);
+
+	/*
+	 * A write followed by a read, with a repeated start. Some adapters
+	 * take nothing else in one transfer (I2C_AQ_COMB_WRITE_THEN_READ),
+	 * so this is probed even if two reads are refused. The i2c core
+	 * then checks the lengths of these two messages against their own
+	 * limits (max_comb_1st_msg_len and max_comb_2nd_msg_len) instead
+	 * of the single message ones.
+	 */
+	q->combined = !probe_rejected(file, msgs, 2);
+	q->pairs_only = q->combined && q->max_msgs < 2;
+	if (q->pairs_only)
+		q->max_msgs = 2;
+	if (q->combined) {
+		q->max_comb_1st_len = probe_len(file, msgs, 2, 0,
+						I2C_XFER_MSG_MAX);
+		q->max_comb_2nd_len = probe_len(file, msgs, 2, 1,
+						I2C_XFER_MSG_MAX);
+	} else {
+		q->max_comb_1st_len = 0;
+		q->max_comb_2nd_len = 0;
+	}
+
+	free(buf);
+	return 0;
+}
+
+int i2c_get_adapter_quirks(int file, struct i2c_adapter_quirks *quirks)
+{
+	int bus, err;
+
+	bus = i2c_fd_get_bus(file);
+	if (bus >= 0 && bus < MAX_CACHED_ADAPTERS
+	 && __atomic_load_n(&quirks_cache[bus].valid, __ATOMIC_ACQUIRE)) {
+		*quirks = quirks_cache[bus].quirks;
+		return 0;
+	}
+
+	err = probe_quirks(file, quirks);
+	if (err < 0)
+		return err;
+
+	if (bus >= 0 && bus < MAX_CACHED_ADAPTERS) {
+		quirks_cache[bus].quirks = *quirks;
+		__atomic_store_n(&quirks_cache[bus].valid, 1, __ATOMIC_RELEASE);
+	}
+	return 0;
+}
+
+/*
+ * Split transfers
+ */
+
+static int flush_batch(int file, struct i2c_msg *batch, int n)
+{
+	if (!n)
+		return 0;
+	return i2c_rdwr(file, batch, n);
+}
+
+__s32 i2c_transfer_split(int file, struct i2c_msg *msgs, int nmsgs)
+{
+	struct i2c_msg batch[I2C_RDWR_IOCTL_MAX_MSGS], piece;
+	struct i2c_adapter_quirks q;
+	unsigned int max_msgs, max_len, off;
+	int i, n = 0, full, err;
+
+	err = i2c_get_adapter_quirks(file, &q);
+	if (err < 0)
+		return err;
+
+	/* Long writes can only be continued without a start condition */
+	for (i = 0; i < nmsgs; i++) {
+		if (!(msgs[i].flags & I2C_M_RD)
+		 && msgs[i].len > q.max_write_len && !q.nostart)
+			return -EOPNOTSUPP;
+	}
+
+	max_msgs = q.combined ? q.max_msgs : 1;
+	for (i = 0; i < nmsgs; i++) {
+		off = 0;
+		do {
+			piece = msgs[i];
+			piece.buf = msgs[i].buf + off;
+			piece.len = msgs[i].len - off;
+
+			/* Received lengths are bounded by the protocol */
+			if (!(piece.flags & I2C_M_RECV_LEN)) {
+				max_len = piece.flags & I2C_M_RD ?
+					  q.max_read_len : q.max_write_len;
+				if (piece.len > max_len)
+					piece.len = max_len;
+			}
+			/* Reads simply go on where the previous one ended */
+			if (off && !(piece.flags & I2C_M_RD))
+				piece.flags |= I2C_M_NOSTART;
+
+			full = (unsigned int)n == max_msgs;
+			/* Only a read of the same chip may follow a write */
+			if (q.pairs_only && n == 1
+			 && ((batch[0].flags & I2C_M_RD)
+			  || !(piece.flags & I2C_M_RD)
+			  || batch[0].addr != piece.addr))
+				full = 1;
+			/* A write then a read go by the combined limits */
+			if (!full && n == 1 && !(batch[0].flags & I2C_M_RD)
+			 && (piece.flags & I2C_M_RD)) {
+				if (batch[0].len > q.max_comb_1st_len)
+					full = 1;
+				else if (!(piece.flags & I2C_M_RECV_LEN)
+				      && piece.len > q.max_comb_2nd_len)
+					piece.len = q.max_comb_2nd_len;
+			}
+			if (full) {
+				/* Can't stop in the middle of a write */
+				if (piece.flags & I2C_M_NOSTART)
+					return -EOPNOTSUPP;
+				err = flush_batch(file, batch, n);
+				if (err < 0)
+					return err;
+				n = 0;
+			}
+			batch[n++] = piece;
+			off += piece.len;
+		} while (off < msgs[i].len);
+	}
+
+	err = flush_batch(file, batch, n);
+	if (err < 0)
+		return err;
+	return nmsgs;
+}
+
+__s32 i2c_transfer(int file, struct i2c_msg *msgs, int nmsgs)
+{
+	struct timespec start;
+	unsigned int bytes = 0;
+	__s32 err;
+	int i;
+
+	if (!(i2c_trace_flags & I2C_TRACE_COUNT))
+		return i2c_transfer_split(file, msgs, nmsgs);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	err = i2c_transfer_split(file, msgs, nmsgs);
+	for (i = 0; i < nmsgs; i++)
+		bytes += msgs[i].flags & I2C_M_RECV_LEN ?
+			 msgs[i].buf[0] + 1 : msgs[i].len;
+	i2c_stats_account(file, nmsgs ? msgs[0].addr : -1, &start, bytes,
+			  err < 0 ? err : 0, 0);
+	return err;
+}
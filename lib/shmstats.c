@@ -0,0 +1,337 @@
+/*
+    shmstats.c - I2C transaction statistics published in shared memory
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <i2c/shmstats.h>
+#include "internal.h"
+
+/* Attempts at reading a slot before giving up on a dead writer */
+#define READ_RETRIES		10000
+
+struct i2c_shm {
+	struct i2c_shm_header hdr;
+	struct i2c_shm_slot slots[I2C_SHM_SLOTS];
+};
+
+static struct i2c_shm *shm_self;
+static char shm_path[32];
+static int shm_forked;		/* publishing again is left to the child */
+
+/*
+ * Publishing
+ */
+
+static struct i2c_shm_slot *find_slot(struct i2c_shm *shm, __u32 key)
+{
+	__u32 i, n, k;
+
+	i = (key * 2654435761U) % I2C_SHM_SLOTS;
+	for (n = 0; n < I2C_SHM_SLOTS; n++, i = (i + 1) % I2C_SHM_SLOTS) {
+		k = __atomic_load_n(&shm->slots[i].key, __ATOMIC_ACQUIRE);
+		if (k == key)
+			return &shm->slots[i];
+		if (k)
+			continue;
+		if (__atomic_compare_exchange_n(&shm->slots[i].key, &k, key,
+						0, __ATOMIC_ACQ_REL,
+						__ATOMIC_ACQUIRE)
+		 || k == key)
+			return &shm->slots[i];
+	}
+
+	return NULL;
+}
+
+static void counter_add(__u64 *counter, __u64 value)
+{
+	/* Only one writer at a time, but readers must not see torn values */
+	__atomic_store_n(counter, *counter + value, __ATOMIC_RELAXED);
+}
+
+void i2c_shm_account(int bus, int addr, __u64 ns, int bucket,
+		     unsigned int bytes, unsigned int wire_bits, __s32 result)
+{
+	struct i2c_shm *shm;
+	struct i2c_shm_slot *slot;
+	struct i2c_shm_counters *c;
+	__u32 seq;
+
+	shm = __atomic_load_n(&shm_self, __ATOMIC_ACQUIRE);
+	if (!shm) {
+		/* First transaction of a forked child, only one thread wins */
+		if (!__atomic_exchange_n(&shm_forked, 0, __ATOMIC_ACQ_REL))
+			return;
+		if (i2c_stats_publish() < 0)
+			return;
+		shm = __atomic_load_n(&shm_self, __ATOMIC_ACQUIRE);
+	}
+	slot = find_slot(shm, ((((__u32)bus & 0xffff) << 16) | addr) + 1);
+	if (!slot)
+		return;
+
+	/* Take the slot from other threads, making seq odd */
+	do {
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) & ~1U;
+	} while (!__atomic_compare_exchange_n(&slot->seq, &seq, seq + 1, 1,
+					      __ATOMIC_ACQUIRE,
+					      __ATOMIC_RELAXED));
+	/* Readers must see seq odd before any of the counter updates */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	c = &slot->counters;
+	counter_add(&c->transactions, 1);
+	counter_add(&c->total_ns, ns);
+	counter_add(&c->latency[bucket], 1);
+	counter_add(&c->wire_bits, wire_bits);
+	if (result < 0)
+		counter_add(&c->failed, 1);
+	else
+		counter_add(&c->bytes, bytes);
+	if (ns > c->max_ns)
+		__atomic_store_n(&c->max_ns, ns, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void shm_unlink_self(void)
+{
+	if (shm_path[0])
+		unlink(shm_path);
+}
+
+/*
+ * The child of a fork inherits the mapping and the path of its parent,
+ * but must neither count in the file of its parent nor remove it at
+ * exit. It publishes its own file at its first transaction instead.
+ */
+static void shm_atfork_child(void)
+{
+	if (!shm_self)
+		return;
+	munmap(shm_self, sizeof(*shm_self));
+	shm_self = NULL;
+	shm_path[0] = '\0';
+	shm_forked = 1;
+}
+
+int i2c_stats_publish(void)
+{
+	static int registered;
+	struct i2c_shm *shm;
+	int fd, err;
+
+	if (shm_self)
+		return 0;
+
+	snprintf(shm_path, sizeof(shm_path), "%s%d", I2C_SHM_PREFIX,
+		 (int)getpid());
+	/*
+	 * A file left by a dead process with the same pid is ours to
+	 * remove, but don't follow links or reuse a file someone else
+	 * planted in the world-writable directory.
+	 */
+	unlink(shm_path);
+	fd = open(shm_path, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW, 0644);
+	if (fd < 0) {
+		err = -errno;
+		goto out_path;
+	}
+	if (ftruncate(fd, sizeof(*shm)) < 0) {
+		err = -errno;
+		goto out_unlink;
+	}
+	shm = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE, MAP_SHARED,
+		   fd, 0);
+	if (shm == MAP_FAILED) {
+		err = -errno;
+		goto out_unlink;
+	}
+	close(fd);
+
+	shm->hdr.version = I2C_SHM_VERSION;
+	shm->hdr.pid = getpid();
+	shm->hdr.nr_slots = I2C_SHM_SLOTS;
+	/* Readers check the magic last */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(shm->hdr.magic, I2C_SHM_MAGIC, sizeof(shm->hdr.magic));
+
+	if (!registered) {
+		atexit(shm_unlink_self);
+		pthread_atfork(NULL, NULL, shm_atfork_child);
+		registered = 1;
+	}
+	__atomic_store_n(&shm_self, shm, __ATOMIC_RELEASE);
+	i2c_trace_flags |= I2C_TRACE_SHM;
+	return 0;
+
+out_unlink:
+	close(fd);
+	unlink(shm_path);
+out_path:
+	shm_path[0] = '\0';
+	return err;
+}
+
+/*
+ * The mapping is left in place, as other threads may still be counting
+ * a transaction in it. Publishing again starts a new file.
+ */
+void i2c_stats_unpublish(void)
+{
+	i2c_trace_flags &= ~I2C_TRACE_SHM;
+	__atomic_store_n(&shm_forked, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&shm_self, NULL, __ATOMIC_RELEASE);
+	shm_unlink_self();
+	shm_path[0] = '\0';
+}
+
+/*
+ * Reading
+ */
+
+struct i2c_shm_stats {
+	struct i2c_shm *shm;	/* mapped read-only */
+};
+
+struct i2c_shm_stats *i2c_shm_open(const char *path)
+{
+	struct i2c_shm_stats *stats;
+	struct i2c_shm *shm;
+	struct stat st;
+	int fd, err;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &st) < 0) {
+		err = errno;
+		goto out_close;
+	}
+	if (st.st_size < (off_t)sizeof(*shm)) {
+		err = EINVAL;
+		goto out_close;
+	}
+
+	shm = mmap(NULL, sizeof(*shm), PROT_READ, MAP_SHARED, fd, 0);
+	if (shm == MAP_FAILED) {
+		err = errno;
+		goto out_close;
+	}
+	close(fd);
+
+	if (memcmp(shm->hdr.magic, I2C_SHM_MAGIC, sizeof(shm->hdr.magic))
+	 || shm->hdr.version != I2C_SHM_VERSION
+	 || shm->hdr.nr_slots != I2C_SHM_SLOTS) {
+		err = EINVAL;
+		goto out_unmap;
+	}
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	stats = malloc(sizeof(*stats));
+	if (!stats) {
+		err = ENOMEM;
+		goto out_unmap;
+	}
+	stats->shm = shm;
+	return stats;
+
+out_unmap:
+	munmap(shm, sizeof(*shm));
+	errno = err;
+	return NULL;
+out_close:
+	close(fd);
+	errno = err;
+	return NULL;
+}
+
+void i2c_shm_close(struct i2c_shm_stats *stats)
+{
+	if (!stats)
+		return;
+	munmap(stats->shm, sizeof(*stats->shm));
+	free(stats);
+}
+
+int i2c_shm_pid(const struct i2c_shm_stats *stats)
+{
+	return stats->shm->hdr.pid;
+}
+
+int i2c_shm_read(const struct i2c_shm_stats *stats, int index, int *bus,
+		 int *addr, struct i2c_shm_counters *counters)
+{
+	const struct i2c_shm_slot *slot;
+	const __u64 *src;
+	__u64 *dst;
+	__u32 seq, key;
+	size_t i;
+	int tries;
+
+	if (index < 0 || index >= I2C_SHM_SLOTS)
+		return -EINVAL;
+	slot = &stats->shm->slots[index];
+	src = (const __u64 *)&slot->counters;
+	dst = (__u64 *)counters;
+
+	for (tries = 0; tries < READ_RETRIES; tries++) {
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		key = __atomic_load_n(&slot->key, __ATOMIC_RELAXED);
+		for (i = 0; i < sizeof(*counters) / sizeof(__u64); i++)
+			dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+			continue;
+
+		if (!key)
+			return 0;
+		key--;
+		*bus = key >> 16 == 0xffff ? -1 : (int)(key >> 16);
+		*addr = key & 0xffff;
+		return 1;
+	}
+
+	/* The writer died in the middle of an update */
+	return -EBUSY;
+}
+
+/* Honor I2C_STATS_SHM for unmodified programs */
+static void __attribute__ ((constructor)) i2c_shm_init(void)
+{
+	const char *env;
+
+	env = getenv("I2C_STATS_SHM");
+	if (env && *env && i2c_stats_publish() < 0)
+		fprintf(stderr, "libi2c: Could not publish statistics\n");
+}
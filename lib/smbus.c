@@ -24,11 +24,14 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <string.h>
+#include <time.h>
 #include <i2c/smbus.h>
 #include <sys/ioctl.h>
 #include <linux/types.h>
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
+#include "internal.h"
 
 /* Compatibility defines */
 #ifndef I2C_SMBUS_I2C_BLOCK_BROKEN
@@ -42,16 +45,40 @@ __s32 i2c_smbus_access(int file, char read_write, __u8 command,
 		       int size, union i2c_smbus_data *data)
 {
 	struct i2c_smbus_ioctl_data args;
+	struct timespec start;
 	__s32 err;
 
+	if (i2c_trace_flags & I2C_TRACE_REPLAY)
+		return i2c_trace_replay(file, i2c_fd_get_addr(file),
+					read_write, command, size, data);
+
 	args.read_write = read_write;
 	args.command = command;
 	args.size = size;
 	args.data = data;
 
+	if (i2c_trace_flags & (I2C_TRACE_LOG | I2C_TRACE_COUNT))
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	I2C_PROBE5(smbus_start, file, i2c_fd_get_addr(file), read_write,
+		   command, size);
 	err = ioctl(file, I2C_SMBUS, &args);
 	if (err == -1)
 		err = -errno;
+	I2C_PROBE6(smbus_done, file, i2c_fd_get_addr(file), read_write,
+		   command, size, err);
+
+	if (i2c_trace_flags & I2C_TRACE_LOG)
+		i2c_trace_record(file, i2c_fd_get_addr(file), &start,
+				 read_write, command, size, data, err);
+	if (i2c_trace_flags & I2C_TRACE_COUNT) {
+		if (err >= 0)
+			i2c_wire_bits += i2c_smbus_wire_bits(read_write, size,
+						data, i2c_fd_get_pec(file));
+		i2c_stats_account(file, i2c_fd_get_addr(file), &start,
+				  i2c_smbus_data_len(read_write, size, data,
+						     err), err, 0);
+	}
 	return err;
 }
 
@@ -136,15 +163,14 @@ __s32 i2c_smbus_process_call(int file, __u8 command, __u16 value)
 __s32 i2c_smbus_read_block_data(int file, __u8 command, __u8 *values)
 {
 	union i2c_smbus_data data;
-	int i, err;
+	int err;
 
 	err = i2c_smbus_access(file, I2C_SMBUS_READ, command,
 			       I2C_SMBUS_BLOCK_DATA, &data);
 	if (err < 0)
 		return err;
 
-	for (i = 1; i <= data.block[0]; i++)
-		values[i-1] = data.block[i];
+	memcpy(values, data.block + 1, data.block[0]);
 	return data.block[0];
 }
 
@@ -152,11 +178,9 @@ __s32 i2c_smbus_write_block_data(int file, __u8 command, __u8 length,
 				 const __u8 *values)
 {
 	union i2c_smbus_data data;
-	int i;
 	if (length > I2C_SMBUS_BLOCK_MAX)
 		length = I2C_SMBUS_BLOCK_MAX;
-	for (i = 1; i <= length; i++)
-		data.block[i] = values[i-1];
+	memcpy(data.block + 1, values, length);
 	data.block[0] = length;
 	return i2c_smbus_access(file, I2C_SMBUS_WRITE, command,
 				I2C_SMBUS_BLOCK_DATA, &data);
@@ -170,7 +194,7 @@ __s32 i2c_smbus_read_i2c_block_data(int file, __u8 command, __u8 length,
 				    __u8 *values)
 {
 	union i2c_smbus_data data;
-	int i, err;
+	int err;
 
 	if (length > I2C_SMBUS_BLOCK_MAX)
 		length = I2C_SMBUS_BLOCK_MAX;
@@ -182,8 +206,7 @@ __s32 i2c_smbus_read_i2c_block_data(int file, __u8 command, __u8 length,
 	if (err < 0)
 		return err;
 
-	for (i = 1; i <= data.block[0]; i++)
-		values[i-1] = data.block[i];
+	memcpy(values, data.block + 1, data.block[0]);
 	return data.block[0];
 }
 
@@ -191,11 +214,9 @@ __s32 i2c_smbus_write_i2c_block_data(int file, __u8 command, __u8 length,
 				     const __u8 *values)
 {
 	union i2c_smbus_data data;
-	int i;
 	if (length > I2C_SMBUS_BLOCK_MAX)
 		length = I2C_SMBUS_BLOCK_MAX;
-	for (i = 1; i <= length; i++)
-		data.block[i] = values[i-1];
+	memcpy(data.block + 1, values, length);
 	data.block[0] = length;
 	return i2c_smbus_access(file, I2C_SMBUS_WRITE, command,
 				I2C_SMBUS_I2C_BLOCK_BROKEN, &data);
@@ -206,12 +227,11 @@ __s32 i2c_smbus_block_process_call(int file, __u8 command, __u8 length,
 				   __u8 *values)
 {
 	union i2c_smbus_data data;
-	int i, err;
+	int err;
 
 	if (length > I2C_SMBUS_BLOCK_MAX)
 		length = I2C_SMBUS_BLOCK_MAX;
-	for (i = 1; i <= length; i++)
-		data.block[i] = values[i-1];
+	memcpy(data.block + 1, values, length);
 	data.block[0] = length;
 
 	err = i2c_smbus_access(file, I2C_SMBUS_WRITE, command,
@@ -219,7 +239,6 @@ __s32 i2c_smbus_block_process_call(int file, __u8 command, __u8 length,
 	if (err < 0)
 		return err;
 
-	for (i = 1; i <= data.block[0]; i++)
-		values[i-1] = data.block[i];
+	memcpy(values, data.block + 1, data.block[0]);
 	return data.block[0];
 }
@@ -0,0 +1,488 @@
+/*
+    stats.c - I2C transaction statistics
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <i2c/stats.h>
+#include "internal.h"
+
+/*
+ * Counters are allocated on first use, per file (same limit as the
+ * address tracking in busses.c) and then per address, and never freed,
+ * so that updates only need atomic additions.
+ */
+#define MAX_STATS_FILES		1024
+#define STATS_ADDRS		(I2C_STATS_UNKNOWN + 1)
+#define STATS_WORDS		(sizeof(struct i2c_stats) / sizeof(__u64))
+
+#define MAX_FREQ_BUSES		1024
+#define DEFAULT_FREQ		100000
+
+__thread unsigned int i2c_wire_bits;
+
+static unsigned int bus_freq[MAX_FREQ_BUSES];	/* set by the program */
+static unsigned int env_freq;			/* from I2C_BUS_FREQ */
+
+struct file_stats {
+	int bus;
+	struct i2c_stats *addr[STATS_ADDRS];
+};
+
+static struct file_stats *file_stats[MAX_STATS_FILES];
+
+static struct file_stats *get_file_stats(int file)
+{
+	struct file_stats *fs, *new;
+
+	fs = __atomic_load_n(&file_stats[file], __ATOMIC_ACQUIRE);
+	if (fs)
+		return fs;
+
+	new = calloc(1, sizeof(*new));
+	if (!new)
+		return NULL;
+	new->bus = i2c_fd_get_bus(file);
+	if (__atomic_compare_exchange_n(&file_stats[file], &fs, new, 0,
+					__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return new;
+	free(new);
+	return fs;
+}
+
+static struct i2c_stats *get_addr_stats(struct file_stats *fs, int addr)
+{
+	struct i2c_stats *st, *new;
+
+	st = __atomic_load_n(&fs->addr[addr], __ATOMIC_ACQUIRE);
+	if (st)
+		return st;
+
+	new = calloc(1, sizeof(*new));
+	if (!new)
+		return NULL;
+	if (__atomic_compare_exchange_n(&fs->addr[addr], &st, new, 0,
+					__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return new;
+	free(new);
+	return st;
+}
+
+static void stats_add(__u64 *counter, __u64 value)
+{
+	__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+/*
+ * Wire time estimation
+ */
+
+/* Start condition and address byte, or 2 bytes for 10-bit addresses */
+#define START_BITS		(1 + 9)
+#define START_BITS_TEN		(1 + 18)
+#define STOP_BITS		1
+
+unsigned int i2c_msgs_wire_bits(const struct i2c_msg *msgs, int nmsgs)
+{
+	unsigned int bits = STOP_BITS;
+	int i;
+
+	for (i = 0; i < nmsgs; i++) {
+		/* i2c-dev doesn't update the length of received blocks */
+		if (msgs[i].flags & I2C_M_RECV_LEN)
+			bits += 9 * (msgs[i].buf[0] + 1);
+		else
+			bits += 9 * msgs[i].len;
+
+		if (msgs[i].flags & I2C_M_NOSTART)
+			continue;
+		bits += msgs[i].flags & I2C_M_TEN ? START_BITS_TEN : START_BITS;
+	}
+
+	return bits;
+}
+
+/*
+ * A write message, a read message or both, lengths are -1 if absent.
+ * With PEC, the kernel appends a PEC byte to the last message of all
+ * but quick commands and I2C block transfers.
+ */
+unsigned int i2c_smbus_wire_bits(char read_write, int size,
+				 const union i2c_smbus_data *data, int pec)
+{
+	int read = read_write == I2C_SMBUS_READ;
+	int wlen = 1, rlen = -1, block = 0;
+
+	if (data && size >= I2C_SMBUS_BLOCK_DATA) {
+		block = data->block[0];
+		if (block > I2C_SMBUS_BLOCK_MAX)
+			block = I2C_SMBUS_BLOCK_MAX;
+	}
+
+	switch (size) {
+	case I2C_SMBUS_QUICK:
+		wlen = 0;
+		break;
+	case I2C_SMBUS_BYTE:
+		if (read) {
+			wlen = -1;
+			rlen = 1;
+		}
+		break;
+	case I2C_SMBUS_BYTE_DATA:
+		if (read)
+			rlen = 1;
+		else
+			wlen = 2;
+		break;
+	case I2C_SMBUS_WORD_DATA:
+		if (read)
+			rlen = 2;
+		else
+			wlen = 3;
+		break;
+	case I2C_SMBUS_PROC_CALL:
+		wlen = 3;
+		rlen = 2;
+		break;
+	case I2C_SMBUS_BLOCK_DATA:
+		if (read)
+			rlen = 1 + block;
+		else
+			wlen = 2 + block;
+		break;
+	case I2C_SMBUS_BLOCK_PROC_CALL:
+		/* The block sent was replaced, assume the same length */
+		wlen = 2 + block;
+		rlen = 1 + block;
+		break;
+	case I2C_SMBUS_I2C_BLOCK_BROKEN:
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		if (read)
+			rlen = block;
+		else
+			wlen = 1 + block;
+		break;
+	}
+
+	if (pec && size != I2C_SMBUS_QUICK
+	 && size != I2C_SMBUS_I2C_BLOCK_BROKEN
+	 && size != I2C_SMBUS_I2C_BLOCK_DATA) {
+		if (rlen >= 0)
+			rlen++;
+		else
+			wlen++;
+	}
+
+	return STOP_BITS + (wlen >= 0 ? START_BITS + 9 * wlen : 0)
+			 + (rlen >= 0 ? START_BITS + 9 * rlen : 0);
+}
+
+unsigned int i2c_get_bus_frequency(int i2cbus)
+{
+	unsigned char be[4];
+	char path[64];
+	unsigned int hz = 0;
+	FILE *f;
+
+	if (i2cbus >= 0 && i2cbus < MAX_FREQ_BUSES && bus_freq[i2cbus])
+		return bus_freq[i2cbus];
+	if (env_freq)
+		return env_freq;
+
+	/* Device tree properties are big-endian */
+	snprintf(path, sizeof(path),
+		 "/sys/class/i2c-adapter/i2c-%d/of_node/clock-frequency",
+		 i2cbus);
+	f = i2cbus >= 0 ? fopen(path, "rb") : NULL;
+	if (f) {
+		if (fread(be, sizeof(be), 1, f) == 1)
+			hz = be[0] << 24 | be[1] << 16 | be[2] << 8 | be[3];
+		fclose(f);
+	}
+
+	return hz ? hz : DEFAULT_FREQ;
+}
+
+void i2c_set_bus_frequency(int i2cbus, unsigned int hz)
+{
+	if (i2cbus >= 0 && i2cbus < MAX_FREQ_BUSES)
+		bus_freq[i2cbus] = hz;
+}
+
+__u64 i2c_stats_wire_ns(__u64 bits, unsigned int hz)
+{
+	return hz ? bits * 1000000000 / hz : 0;
+}
+
+/*
+ * Accounting
+ */
+
+void i2c_stats_account(int file, int addr, const struct timespec *start,
+		       unsigned int bytes, __s32 result, unsigned int retries)
+{
+	struct file_stats *fs = NULL;
+	struct i2c_stats *st;
+	struct timespec end;
+	unsigned int bits;
+	__u64 ns, max;
+	int bucket;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	bits = i2c_wire_bits;
+	i2c_wire_bits = 0;
+
+	ns = (__u64)(end.tv_sec - start->tv_sec) * 1000000000
+	   + end.tv_nsec - start->tv_nsec;
+	bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+	if (bucket >= I2C_STATS_BUCKETS)
+		bucket = I2C_STATS_BUCKETS - 1;
+	if (addr < 0 || addr >= I2C_STATS_UNKNOWN)
+		addr = I2C_STATS_UNKNOWN;
+
+	/* The file stats remember the bus, to save an fstat() */
+	if (file >= 0 && file < MAX_STATS_FILES)
+		fs = get_file_stats(file);
+
+	if (i2c_trace_flags & I2C_TRACE_SHM)
+		i2c_shm_account(fs ? fs->bus : i2c_fd_get_bus(file), addr, ns,
+				bucket, bytes, bits, result);
+
+	if (!fs || !(i2c_trace_flags & I2C_TRACE_STATS))
+		return;
+	st = get_addr_stats(fs, addr);
+	if (!st)
+		return;
+
+	stats_add(&st->transactions, 1);
+	stats_add(&st->total_ns, ns);
+	stats_add(&st->latency[bucket], 1);
+	stats_add(&st->wire_bits, bits);
+	if (retries)
+		stats_add(&st->retries, retries);
+	if (result < 0) {
+		stats_add(&st->failed, 1);
+		stats_add(&st->errors[-result < I2C_STATS_ERRNOS ? -result : 0],
+			  1);
+	} else {
+		stats_add(&st->bytes, bytes);
+	}
+
+	max = __atomic_load_n(&st->max_ns, __ATOMIC_RELAXED);
+	while (ns > max
+	    && !__atomic_compare_exchange_n(&st->max_ns, &max, ns, 1,
+					    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+void i2c_stats_start(void)
+{
+	i2c_trace_flags |= I2C_TRACE_STATS;
+}
+
+void i2c_stats_stop(void)
+{
+	i2c_trace_flags &= ~I2C_TRACE_STATS;
+}
+
+/* Add the counters of st to sum */
+static void stats_sum(struct i2c_stats *sum, struct i2c_stats *st)
+{
+	__u64 *dst = (__u64 *)sum, *src = (__u64 *)st, max;
+	size_t i;
+
+	for (i = 0; i < STATS_WORDS; i++)
+		dst[i] += __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+
+	/* Undo the addition of max_ns */
+	max = __atomic_load_n(&st->max_ns, __ATOMIC_RELAXED);
+	sum->max_ns -= max;
+	if (max > sum->max_ns)
+		sum->max_ns = max;
+}
+
+int i2c_stats_get(int file, int addr, struct i2c_stats *stats)
+{
+	struct file_stats *fs;
+	struct i2c_stats *st;
+	int i, found = 0;
+
+	memset(stats, 0, sizeof(*stats));
+	if (file < 0 || file >= MAX_STATS_FILES
+	 || addr < I2C_STATS_ALL || addr > I2C_STATS_UNKNOWN)
+		return -ENOENT;
+	fs = __atomic_load_n(&file_stats[file], __ATOMIC_ACQUIRE);
+	if (!fs)
+		return -ENOENT;
+
+	for (i = 0; i < STATS_ADDRS; i++) {
+		if (addr != I2C_STATS_ALL && addr != i)
+			continue;
+		st = __atomic_load_n(&fs->addr[i], __ATOMIC_ACQUIRE);
+		if (!st)
+			continue;
+		stats_sum(stats, st);
+		found = 1;
+	}
+
+	return found && stats->transactions ? 0 : -ENOENT;
+}
+
+static void reset_file(int file)
+{
+	struct file_stats *fs;
+	struct i2c_stats *st;
+	size_t i, j;
+
+	fs = __atomic_load_n(&file_stats[file], __ATOMIC_ACQUIRE);
+	if (!fs)
+		return;
+
+	fs->bus = i2c_fd_get_bus(file);
+	for (i = 0; i < STATS_ADDRS; i++) {
+		st = __atomic_load_n(&fs->addr[i], __ATOMIC_ACQUIRE);
+		if (!st)
+			continue;
+		for (j = 0; j < STATS_WORDS; j++)
+			__atomic_store_n(&((__u64 *)st)[j], 0,
+					 __ATOMIC_RELAXED);
+	}
+}
+
+void i2c_stats_reset(int file)
+{
+	int i;
+
+	if (file >= 0 && file < MAX_STATS_FILES) {
+		reset_file(file);
+		return;
+	}
+	if (file == -1)
+		for (i = 0; i < MAX_STATS_FILES; i++)
+			reset_file(i);
+}
+
+__u64 i2c_stats_percentile(const struct i2c_stats *stats, unsigned int pct)
+{
+	__u64 count = 0, bound;
+	int i;
+
+	if (!stats->transactions)
+		return 0;
+
+	for (i = 0; i < I2C_STATS_BUCKETS - 1; i++) {
+		count += stats->latency[i];
+		if (count * 100 >= stats->transactions * pct)
+			break;
+	}
+
+	/* The upper bound of the bucket, or better, the worst case seen */
+	bound = i < I2C_STATS_BUCKETS - 1 ? 2ULL << i : stats->max_ns;
+	return bound < stats->max_ns ? bound : stats->max_ns;
+}
+
+/*
+ * Summary at exit, with I2C_STATS set
+ */
+
+static void stats_print(void)
+{
+	struct i2c_stats st;
+	struct file_stats *fs;
+	__u64 wire_ns;
+	int file, addr, e;
+
+	for (file = 0; file < MAX_STATS_FILES; file++) {
+		fs = file_stats[file];
+		if (!fs)
+			continue;
+		for (addr = 0; addr < STATS_ADDRS; addr++) {
+			if (i2c_stats_get(file, addr, &st) < 0)
+				continue;
+
+			fprintf(stderr, "libi2c: i2c-%d ", fs->bus);
+			if (addr == I2C_STATS_UNKNOWN)
+				fprintf(stderr, "unknown");
+			else
+				fprintf(stderr, "0x%02x", addr);
+			fprintf(stderr, ": %llu transactions, %llu bytes, "
+				"latency avg %llu us, p99 %llu us, max %llu us",
+				(unsigned long long)st.transactions,
+				(unsigned long long)st.bytes,
+				(unsigned long long)(st.total_ns /
+						     st.transactions / 1000),
+				(unsigned long long)
+				i2c_stats_percentile(&st, 99) / 1000,
+				(unsigned long long)st.max_ns / 1000);
+			wire_ns = i2c_stats_wire_ns(st.wire_bits,
+					i2c_get_bus_frequency(fs->bus));
+			if (wire_ns && st.total_ns)
+				fprintf(stderr, ", wire avg %llu us (%llu%% of "
+					"latency)", (unsigned long long)
+					(wire_ns / st.transactions / 1000),
+					(unsigned long long)
+					(wire_ns * 100 / st.total_ns));
+			if (st.retries)
+				fprintf(stderr, ", %llu retries",
+					(unsigned long long)st.retries);
+			if (st.failed) {
+				fprintf(stderr, ", %llu errors",
+					(unsigned long long)st.failed);
+				for (e = 1; e < I2C_STATS_ERRNOS; e++) {
+					if (st.errors[e])
+						fprintf(stderr, " (%llu %s)",
+							(unsigned long long)
+							st.errors[e],
+							strerror(e));
+				}
+				if (st.errors[0])
+					fprintf(stderr, " (%llu other)",
+						(unsigned long long)
+						st.errors[0]);
+			}
+			fprintf(stderr, "\n");
+		}
+	}
+}
+
+static void __attribute__ ((constructor)) i2c_stats_init(void)
+{
+	const char *env;
+	char *end;
+
+	env = getenv("I2C_BUS_FREQ");
+	if (env && *env) {
+		env_freq = strtoul(env, &end, 0);
+		if (*end)
+			env_freq = 0;
+	}
+
+	env = getenv("I2C_STATS");
+	if (!env || !*env)
+		return;
+
+	i2c_stats_start();
+	atexit(stats_print);
+}
@@ -0,0 +1,633 @@
+/*
+    trace.c - SMBus transaction recording, timeline and replay
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <i2c/smbus.h>
+#include <i2c/trace.h>
+#include "internal.h"
+
+/*
+ * Trace file format: an 8-byte header (magic and version), followed by
+ * one entry per transaction: a fixed 32-byte part holding the fields of
+ * struct i2c_trace_record up to len, then len data bytes. All fields
+ * are in host byte order, traces are not meant to travel across
+ * architectures.
+ */
+#define TRACE_MAGIC		"I2CTRC"
+#define TRACE_VERSION		1
+#define TRACE_HDR_SIZE		8
+#define TRACE_ENTRY_SIZE	offsetof(struct i2c_trace_record, data)
+
+int i2c_trace_flags;
+
+/* Held while writing to record_file, so that it isn't closed meanwhile */
+static pthread_mutex_t record_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *record_file;
+static struct i2c_replay *replay_global;
+
+/*
+ * The timeline ring: slot seq is the index of the record it holds plus
+ * one, or 0 while the record is being written. The ring is allocated on
+ * first start and kept for the life of the process, so that it can be
+ * saved after stopping, and writers never race with a free.
+ */
+struct timeline_slot {
+	__u64 seq;
+	struct i2c_trace_record rec;
+};
+
+static struct timeline_slot *timeline;
+static unsigned int timeline_size;	/* power of two */
+static __u64 timeline_head;
+static FILE *timeline_file;		/* from I2C_TIMELINE */
+
+int i2c_smbus_data_len(char read_write, int size,
+		       const union i2c_smbus_data *data, __s32 result)
+{
+	int len;
+
+	if (!data || result < 0)
+		return 0;
+
+	switch (size) {
+	case I2C_SMBUS_BYTE:
+		return read_write == I2C_SMBUS_READ ? 1 : 0;
+	case I2C_SMBUS_BYTE_DATA:
+		return 1;
+	case I2C_SMBUS_WORD_DATA:
+	case I2C_SMBUS_PROC_CALL:
+		return 2;
+	case I2C_SMBUS_BLOCK_DATA:
+	case I2C_SMBUS_I2C_BLOCK_BROKEN:
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+	case I2C_SMBUS_BLOCK_PROC_CALL:
+		len = data->block[0];
+		if (len > I2C_SMBUS_BLOCK_MAX)
+			len = I2C_SMBUS_BLOCK_MAX;
+		return len + 1;
+	}
+
+	return 0;
+}
+
+static __u64 timespec_ns(const struct timespec *ts)
+{
+	return (__u64)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static __u32 trace_gettid(void)
+{
+	static __thread __u32 tid;
+
+	if (!tid)
+		tid = syscall(SYS_gettid);
+	return tid;
+}
+
+static FILE *trace_create(const char *path)
+{
+	FILE *f;
+	unsigned char hdr[TRACE_HDR_SIZE] = TRACE_MAGIC;
+
+	f = fopen(path, "wb");
+	if (!f)
+		return NULL;
+
+	hdr[6] = TRACE_VERSION;
+	if (fwrite(hdr, sizeof(hdr), 1, f) != 1) {
+		fclose(f);
+		errno = EIO;
+		return NULL;
+	}
+
+	return f;
+}
+
+static int trace_write(FILE *f, const struct i2c_trace_record *rec)
+{
+	/* A single fwrite, stdio locking keeps records from interleaving */
+	if (fwrite(rec, TRACE_ENTRY_SIZE + rec->len, 1, f) != 1)
+		return -EIO;
+	return 0;
+}
+
+/*
+ * Timeline
+ */
+
+static void timeline_add(const struct i2c_trace_record *rec)
+{
+	struct timeline_slot *ring, *slot;
+	__u64 i;
+
+	ring = __atomic_load_n(&timeline, __ATOMIC_ACQUIRE);
+	if (!ring)
+		return;
+	i = __atomic_fetch_add(&timeline_head, 1, __ATOMIC_RELAXED);
+	slot = &ring[i & (timeline_size - 1)];
+
+	__atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&slot->rec, rec, TRACE_ENTRY_SIZE + rec->len);
+	__atomic_store_n(&slot->seq, i + 1, __ATOMIC_RELEASE);
+}
+
+/* Later starts go on with the ring of the first one, whatever its size */
+int i2c_timeline_start(unsigned int records)
+{
+	struct timeline_slot *ring;
+	unsigned int size = 1;
+
+	if (!timeline) {
+		if (!records)
+			records = I2C_TIMELINE_DEFAULT;
+		while (size < records && size < 0x80000000U)
+			size <<= 1;
+		ring = calloc(size, sizeof(*ring));
+		if (!ring)
+			return -ENOMEM;
+		timeline_size = size;
+		__atomic_store_n(&timeline, ring, __ATOMIC_RELEASE);
+	}
+
+	i2c_trace_flags |= I2C_TRACE_TIMELINE;
+	return 0;
+}
+
+void i2c_timeline_stop(void)
+{
+	i2c_trace_flags &= ~I2C_TRACE_TIMELINE;
+}
+
+static int timeline_write(FILE *f)
+{
+	struct timeline_slot *slot;
+	struct i2c_trace_record rec;
+	__u64 i, head;
+	int err = 0;
+
+	head = __atomic_load_n(&timeline_head, __ATOMIC_ACQUIRE);
+	for (i = head > timeline_size ? head - timeline_size : 0; i < head;
+	     i++) {
+		slot = &timeline[i & (timeline_size - 1)];
+		if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != i + 1)
+			continue;
+		memcpy(&rec, &slot->rec, sizeof(rec));
+		/* Overwritten while we copied it */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != i + 1)
+			continue;
+
+		err = trace_write(f, &rec);
+		if (err < 0)
+			break;
+	}
+
+	if (fclose(f) && !err)
+		err = -EIO;
+	return err;
+}
+
+int i2c_timeline_save(const char *path)
+{
+	FILE *f;
+
+	if (!timeline)
+		return -ENOENT;
+
+	f = trace_create(path);
+	if (!f)
+		return -errno;
+	return timeline_write(f);
+}
+
+static void timeline_save_exit(void)
+{
+	i2c_timeline_stop();
+	if (timeline_write(timeline_file) < 0)
+		fprintf(stderr, "libi2c: Could not save timeline\n");
+}
+
+/*
+ * Recording
+ */
+
+int i2c_record_start(const char *path)
+{
+	FILE *f;
+
+	f = trace_create(path);
+	if (!f)
+		return -errno;
+
+	i2c_record_stop();
+	pthread_mutex_lock(&record_lock);
+	record_file = f;
+	pthread_mutex_unlock(&record_lock);
+	i2c_trace_flags |= I2C_TRACE_RECORD;
+	return 0;
+}
+
+void i2c_record_stop(void)
+{
+	FILE *f;
+
+	i2c_trace_flags &= ~I2C_TRACE_RECORD;
+
+	/* Wait for writers which saw the flag still set */
+	pthread_mutex_lock(&record_lock);
+	f = record_file;
+	record_file = NULL;
+	pthread_mutex_unlock(&record_lock);
+
+	if (f)
+		fclose(f);
+}
+
+static void record_write(const struct i2c_trace_record *rec)
+{
+	pthread_mutex_lock(&record_lock);
+	if (record_file)
+		trace_write(record_file, rec);
+	pthread_mutex_unlock(&record_lock);
+}
+
+void i2c_trace_record(int file, int addr, const struct timespec *start,
+		      char read_write, __u8 command, int size,
+		      const union i2c_smbus_data *data, __s32 result)
+{
+	struct i2c_trace_record rec;
+	struct timespec end;
+	int bus;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	bus = i2c_fd_get_bus(file);
+
+	rec.timestamp = timespec_ns(start);
+	rec.duration = timespec_ns(&end) - rec.timestamp;
+	rec.result = result;
+	rec.tid = trace_gettid();
+	rec.fd = file;
+	rec.bus = bus < 0 ? I2C_TRACE_UNKNOWN : bus;
+	rec.addr = addr < 0 ? I2C_TRACE_UNKNOWN : addr;
+	rec.read_write = read_write;
+	rec.command = command;
+	rec.size = size;
+	rec.len = i2c_smbus_data_len(read_write, size, data, result);
+	if (rec.len)
+		memcpy(rec.data, data, rec.len);
+
+	if (i2c_trace_flags & I2C_TRACE_RECORD)
+		record_write(&rec);
+	if (i2c_trace_flags & I2C_TRACE_TIMELINE)
+		timeline_add(&rec);
+}
+
+void i2c_trace_rdwr(int file, const struct timespec *start,
+		    const struct i2c_msg *msgs, int nmsgs, __s32 result)
+{
+	struct i2c_trace_record rec;
+	struct timespec end;
+	int i, bus;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	bus = i2c_fd_get_bus(file);
+
+	rec.timestamp = timespec_ns(start);
+	rec.duration = timespec_ns(&end) - rec.timestamp;
+	rec.result = result;
+	rec.tid = trace_gettid();
+	rec.fd = file;
+	rec.bus = bus < 0 ? I2C_TRACE_UNKNOWN : bus;
+	rec.addr = msgs[0].addr;
+	rec.read_write = I2C_SMBUS_WRITE;
+	rec.command = 0;
+	rec.size = I2C_TRACE_RDWR;
+	rec.len = 0;
+
+	for (i = nmsgs - 1; i >= 0; i--) {
+		if (msgs[i].flags & I2C_M_RD)
+			rec.read_write = I2C_SMBUS_READ;
+		else if (msgs[i].len)
+			rec.command = msgs[i].buf[0];
+	}
+
+	timeline_add(&rec);
+}
+
+/*
+ * Reading
+ */
+
+struct i2c_trace {
+	FILE *f;
+};
+
+struct i2c_trace *i2c_trace_open(const char *path)
+{
+	struct i2c_trace *trace;
+	unsigned char hdr[TRACE_HDR_SIZE];
+
+	trace = malloc(sizeof(*trace));
+	if (!trace)
+		return NULL;
+
+	trace->f = fopen(path, "rb");
+	if (!trace->f) {
+		free(trace);
+		return NULL;
+	}
+
+	if (fread(hdr, sizeof(hdr), 1, trace->f) != 1
+	 || memcmp(hdr, TRACE_MAGIC, 6) || hdr[6] != TRACE_VERSION) {
+		i2c_trace_close(trace);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return trace;
+}
+
+int i2c_trace_read(struct i2c_trace *trace, struct i2c_trace_record *rec)
+{
+	size_t got;
+
+	got = fread(rec, 1, TRACE_ENTRY_SIZE, trace->f);
+	if (got == 0 && feof(trace->f))
+		return 0;
+	if (got != TRACE_ENTRY_SIZE || rec->len > sizeof(rec->data))
+		return -EINVAL;
+
+	memset(rec->data, 0, sizeof(rec->data));
+	if (rec->len && fread(rec->data, rec->len, 1, trace->f) != 1)
+		return -EINVAL;
+
+	return 1;
+}
+
+void i2c_trace_close(struct i2c_trace *trace)
+{
+	if (!trace)
+		return;
+	fclose(trace->f);
+	free(trace);
+}
+
+/*
+ * Replay
+ *
+ * Records are grouped by transaction key (bus, address, direction,
+ * command, size), in recording order. Each group has its own cursor.
+ */
+
+struct replay_run {
+	const struct i2c_trace_record *first;
+	int count;
+	int cursor;
+};
+
+struct i2c_replay {
+	struct i2c_trace_record *recs;
+	int nr_recs;
+	struct replay_run *runs;
+	int nr_runs;
+};
+
+static int replay_key_cmp(const struct i2c_trace_record *a,
+			  const struct i2c_trace_record *b)
+{
+	if (a->bus != b->bus)
+		return a->bus < b->bus ? -1 : 1;
+	if (a->addr != b->addr)
+		return a->addr < b->addr ? -1 : 1;
+	if (a->read_write != b->read_write)
+		return a->read_write < b->read_write ? -1 : 1;
+	if (a->command != b->command)
+		return a->command < b->command ? -1 : 1;
+	if (a->size != b->size)
+		return a->size < b->size ? -1 : 1;
+	return 0;
+}
+
+static int replay_sort_cmp(const void *pa, const void *pb)
+{
+	const struct i2c_trace_record *a = pa, *b = pb;
+	int cmp;
+
+	cmp = replay_key_cmp(a, b);
+	if (cmp)
+		return cmp;
+	return a->timestamp < b->timestamp ? -1 : a->timestamp > b->timestamp;
+}
+
+static int replay_run_cmp(const void *key, const void *prun)
+{
+	const struct replay_run *run = prun;
+
+	return replay_key_cmp(key, run->first);
+}
+
+struct i2c_replay *i2c_replay_open(const char *path)
+{
+	struct i2c_replay *replay;
+	struct i2c_trace *trace;
+	int i, err, max_recs = 0;
+
+	trace = i2c_trace_open(path);
+	if (!trace)
+		return NULL;
+
+	replay = calloc(1, sizeof(*replay));
+	if (!replay) {
+		err = -ENOMEM;
+		goto out_close;
+	}
+
+	for (;;) {
+		if (replay->nr_recs == max_recs) {
+			struct i2c_trace_record *recs;
+
+			max_recs = max_recs ? 2 * max_recs : 256;
+			recs = realloc(replay->recs,
+				       max_recs * sizeof(*recs));
+			if (!recs) {
+				err = -ENOMEM;
+				goto out_free;
+			}
+			replay->recs = recs;
+		}
+
+		err = i2c_trace_read(trace, &replay->recs[replay->nr_recs]);
+		if (err < 0)
+			goto out_free;
+		if (err == 0)
+			break;
+		replay->nr_recs++;
+	}
+	i2c_trace_close(trace);
+
+	qsort(replay->recs, replay->nr_recs, sizeof(*replay->recs),
+	      replay_sort_cmp);
+
+	replay->runs = calloc(replay->nr_recs ? replay->nr_recs : 1,
+			      sizeof(*replay->runs));
+	if (!replay->runs) {
+		i2c_replay_close(replay);
+		errno = ENOMEM;
+		return NULL;
+	}
+	for (i = 0; i < replay->nr_recs; i++) {
+		struct replay_run *run = &replay->runs[replay->nr_runs];
+
+		if (i && !replay_key_cmp(&replay->recs[i],
+					 replay->runs[replay->nr_runs - 1].first)) {
+			replay->runs[replay->nr_runs - 1].count++;
+			continue;
+		}
+		run->first = &replay->recs[i];
+		run->count = 1;
+		replay->nr_runs++;
+	}
+
+	return replay;
+
+out_free:
+	i2c_replay_close(replay);
+out_close:
+	i2c_trace_close(trace);
+	errno = -err;
+	return NULL;
+}
+
+void i2c_replay_close(struct i2c_replay *replay)
+{
+	if (!replay)
+		return;
+	free(replay->recs);
+	free(replay->runs);
+	free(replay);
+}
+
+__s32 i2c_replay_access(struct i2c_replay *replay, int bus, int addr,
+			char read_write, __u8 command, int size,
+			union i2c_smbus_data *data)
+{
+	struct i2c_trace_record key;
+	const struct i2c_trace_record *rec;
+	struct replay_run *run;
+	int cursor, next;
+
+	key.bus = bus < 0 ? I2C_TRACE_UNKNOWN : bus;
+	key.addr = addr < 0 ? I2C_TRACE_UNKNOWN : addr;
+	key.read_write = read_write;
+	key.command = command;
+	key.size = size;
+
+	run = bsearch(&key, replay->runs, replay->nr_runs,
+		      sizeof(*replay->runs), replay_run_cmp);
+	if (!run)
+		return read_write == I2C_SMBUS_WRITE
+		    && size != I2C_SMBUS_PROC_CALL
+		    && size != I2C_SMBUS_BLOCK_PROC_CALL ? 0 : -ENXIO;
+
+	/* Concurrent callers each get their own record */
+	cursor = __atomic_load_n(&run->cursor, __ATOMIC_RELAXED);
+	do {
+		next = cursor + 1 == run->count ? 0 : cursor + 1;
+	} while (!__atomic_compare_exchange_n(&run->cursor, &cursor, next, 1,
+					      __ATOMIC_RELAXED,
+					      __ATOMIC_RELAXED));
+	rec = run->first + cursor;
+
+	/* Only hand back data the caller expects to receive */
+	if (rec->len && data
+	 && (read_write == I2C_SMBUS_READ || size == I2C_SMBUS_PROC_CALL
+	  || size == I2C_SMBUS_BLOCK_PROC_CALL))
+		memcpy(data, rec->data, rec->len);
+
+	return rec->result;
+}
+
+int i2c_replay_start(const char *path)
+{
+	struct i2c_replay *replay;
+
+	replay = i2c_replay_open(path);
+	if (!replay)
+		return -errno;
+
+	i2c_replay_stop();
+	replay_global = replay;
+	i2c_trace_flags |= I2C_TRACE_REPLAY;
+	return 0;
+}
+
+void i2c_replay_stop(void)
+{
+	i2c_trace_flags &= ~I2C_TRACE_REPLAY;
+	i2c_replay_close(replay_global);
+	replay_global = NULL;
+}
+
+__s32 i2c_trace_replay(int file, int addr, char read_write, __u8 command,
+		       int size, union i2c_smbus_data *data)
+{
+	return i2c_replay_access(replay_global, i2c_fd_get_bus(file), addr,
+				 read_write, command, size, data);
+}
+
+/* Honor I2C_RECORD, I2C_TIMELINE and I2C_REPLAY for unmodified programs */
+static void __attribute__ ((constructor)) i2c_trace_init(void)
+{
+	const char *path;
+
+	path = getenv("I2C_REPLAY");
+	if (path && *path && i2c_replay_start(path) < 0)
+		fprintf(stderr, "libi2c: Could not replay %s\n", path);
+
+	path = getenv("I2C_RECORD");
+	if (path && *path && i2c_record_start(path) < 0)
+		fprintf(stderr, "libi2c: Could not record to %s\n", path);
+
+	/* The file is created now, the program may change directory */
+	path = getenv("I2C_TIMELINE");
+	if (path && *path) {
+		timeline_file = trace_create(path);
+		if (timeline_file && i2c_timeline_start(0) == 0) {
+			atexit(timeline_save_exit);
+		} else {
+			if (timeline_file)
+				fclose(timeline_file);
+			fprintf(stderr, "libi2c: Could not record timeline to "
+				"%s\n", path);
+		}
+	}
+}
@@ -0,0 +1,659 @@
+/*
+    xfer.c - SMBus transactions over I2C_RDWR, addressed per call
+
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <i2c/xfer.h>
+#include <sys/ioctl.h>
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "internal.h"
+
+/* Compatibility defines */
+#ifndef I2C_SMBUS_I2C_BLOCK_BROKEN
+#define I2C_SMBUS_I2C_BLOCK_BROKEN I2C_SMBUS_I2C_BLOCK_DATA
+#endif
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS	42
+#endif
+#ifndef I2C_M_RECV_LEN
+#define I2C_M_RECV_LEN	0x0400
+#endif
+
+/* CRC-8, polynomial x^8 + x^2 + x + 1, as used by SMBus PEC */
+static const __u8 crc8_table[256] = {
+	0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15,
+	0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+	0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65,
+	0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+	0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5,
+	0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+	0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85,
+	0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+	0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2,
+	0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+	0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2,
+	0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+	0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32,
+	0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+	0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42,
+	0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+	0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c,
+	0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+	0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec,
+	0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+	0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c,
+	0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+	0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c,
+	0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+	0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b,
+	0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+	0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b,
+	0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+	0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb,
+	0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+	0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb,
+	0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3,
+};
+
+__u8 i2c_smbus_pec(__u8 crc, const __u8 *buf, size_t count)
+{
+	while (count--)
+		crc = crc8_table[crc ^ *buf++];
+	return crc;
+}
+
+/* PEC covers the address byte of each message, then its data */
+static __u8 msg_pec(__u8 crc, const struct i2c_msg *msg, int len)
+{
+	__u8 addr = (msg->addr << 1) | (msg->flags & I2C_M_RD);
+
+	crc = i2c_smbus_pec(crc, &addr, 1);
+	return i2c_smbus_pec(crc, msg->buf, len);
+}
+
+/* Data bytes of messages, as announced to the probes */
+static inline unsigned int msgs_len(const struct i2c_msg *msgs, int nmsgs)
+{
+	unsigned int len = 0;
+	int i;
+
+	for (i = 0; i < nmsgs; i++)
+		len += msgs[i].len;
+	return len;
+}
+
+int i2c_rdwr(int file, struct i2c_msg *msgs, int nmsgs)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+	struct timespec start;
+	int err;
+
+	if (i2c_trace_flags & I2C_TRACE_TIMELINE)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	I2C_PROBE4(rdwr_start, file, msgs[0].addr, nmsgs,
+		   msgs_len(msgs, nmsgs));
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = nmsgs;
+	err = ioctl(file, I2C_RDWR, &rdwr);
+	if (err < 0)
+		err = -errno;
+	I2C_PROBE4(rdwr_done, file, msgs[0].addr, nmsgs, err < 0 ? err : 0);
+
+	if ((i2c_trace_flags & I2C_TRACE_COUNT) && err >= 0)
+		i2c_wire_bits += i2c_msgs_wire_bits(msgs, nmsgs);
+
+	if (i2c_trace_flags & I2C_TRACE_TIMELINE)
+		i2c_trace_rdwr(file, &start, msgs, nmsgs, err);
+	return err < 0 ? err : 0;
+}
+
+/*
+ * Encode an SMBus transaction as I2C messages, the same way the kernel
+ * emulates SMBus on plain I2C adapters: a write message holding the
+ * command and any data, optionally followed by a read message after a
+ * repeated start. All state lives on the stack, so this is reentrant.
+ *
+ * buf is laid out like union i2c_smbus_data, except that blocks may
+ * hold up to max bytes (after the length byte), and must have room for
+ * max + 2 bytes. With I2C_XFER_PEC, the PEC byte is computed and
+ * appended to writes, and requested and checked on reads.
+ */
+static __s32 smbus_xfer_rdwr(int file, __u16 addr, __u16 flags,
+			     char read_write, __u8 command, int size,
+			     __u8 *buf, int max)
+{
+	unsigned char wbuf[I2C_SMBUS3_BLOCK_MAX + 3];
+	unsigned char rbuf[3];
+	struct i2c_msg msgs[2], *last;
+	int nmsgs, len, pec, err;
+	__u16 word;
+	__u8 crc = 0;
+
+	pec = (flags & I2C_XFER_PEC) && size != I2C_SMBUS_QUICK
+	   && size != I2C_SMBUS_I2C_BLOCK_BROKEN
+	   && size != I2C_SMBUS_I2C_BLOCK_DATA;
+
+	flags &= I2C_M_TEN;
+	msgs[0].addr = addr;
+	msgs[0].flags = flags;
+	msgs[0].len = 1;
+	msgs[0].buf = wbuf;
+	msgs[1].addr = addr;
+	msgs[1].flags = flags | I2C_M_RD;
+	msgs[1].len = 0;
+	msgs[1].buf = rbuf;
+	wbuf[0] = command;
+	nmsgs = read_write == I2C_SMBUS_READ ? 2 : 1;
+
+	switch (size) {
+	case I2C_SMBUS_QUICK:
+		msgs[0].len = 0;
+		if (read_write == I2C_SMBUS_READ)
+			msgs[0].flags |= I2C_M_RD;
+		nmsgs = 1;
+		break;
+	case I2C_SMBUS_BYTE:
+		if (read_write == I2C_SMBUS_READ) {
+			/* Special case: only a read */
+			msgs[0].flags |= I2C_M_RD;
+			msgs[0].len = 1;
+			msgs[0].buf = rbuf;
+			nmsgs = 1;
+		}
+		break;
+	case I2C_SMBUS_BYTE_DATA:
+		if (read_write == I2C_SMBUS_READ) {
+			msgs[1].len = 1;
+		} else {
+			msgs[0].len = 2;
+			wbuf[1] = buf[0];
+		}
+		break;
+	case I2C_SMBUS_WORD_DATA:
+	case I2C_SMBUS_PROC_CALL:
+		if (read_write == I2C_SMBUS_READ) {
+			msgs[1].len = 2;
+			break;
+		}
+		memcpy(&word, buf, sizeof(word));
+		msgs[0].len = 3;
+		wbuf[1] = word & 0xff;
+		wbuf[2] = word >> 8;
+		if (size == I2C_SMBUS_PROC_CALL) {
+			msgs[1].len = 2;
+			nmsgs = 2;
+		}
+		break;
+	case I2C_SMBUS_BLOCK_DATA:
+	case I2C_SMBUS_BLOCK_PROC_CALL:
+		if (read_write == I2C_SMBUS_WRITE) {
+			len = buf[0];
+			if (len == 0 || len > max)
+				return -EINVAL;
+			msgs[0].len = len + 2;
+			memcpy(wbuf + 1, buf, len + 1);
+			if (size == I2C_SMBUS_BLOCK_DATA)
+				break;
+			nmsgs = 2;
+		}
+		/* The slave sends the length first, buf[0] is where
+		   i2c-dev wants the number of bytes to read beyond it */
+		msgs[1].flags |= I2C_M_RECV_LEN;
+		msgs[1].len = 1 + max + pec;
+		msgs[1].buf = buf;
+		buf[0] = 1 + pec;
+		break;
+	case I2C_SMBUS_I2C_BLOCK_BROKEN:
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		/* i2c-dev always reads 32 bytes for the old transaction */
+		if (size == I2C_SMBUS_I2C_BLOCK_BROKEN
+		 && read_write == I2C_SMBUS_READ)
+			buf[0] = I2C_SMBUS_BLOCK_MAX;
+		len = buf[0];
+		if (len > max)
+			return -EINVAL;
+		if (read_write == I2C_SMBUS_READ) {
+			msgs[1].len = len;
+			msgs[1].buf = buf + 1;
+		} else {
+			msgs[0].len = len + 1;
+			memcpy(wbuf + 1, buf + 1, len);
+		}
+		break;
+	default:
+		return -EOPNOTSUPP;
+	}
+
+	last = &msgs[nmsgs - 1];
+	if (pec) {
+		/* Compute PEC if first message is a write */
+		if (!(msgs[0].flags & I2C_M_RD)) {
+			crc = msg_pec(0, &msgs[0], msgs[0].len);
+			if (nmsgs == 1)		/* Write only */
+				wbuf[msgs[0].len++] = crc;
+		}
+		/* Ask for PEC if last message is a read, received blocks
+		   already have room for it */
+		if ((last->flags & I2C_M_RD) && !(last->flags & I2C_M_RECV_LEN))
+			last->len++;
+	}
+
+	err = i2c_rdwr(file, msgs, nmsgs);
+	if (err < 0)
+		return err;
+
+	if (!(last->flags & I2C_M_RD))
+		return 0;
+
+	/* i2c-dev doesn't report the received length of blocks */
+	if (last->flags & I2C_M_RECV_LEN) {
+		if (buf[0] > max)
+			return -EPROTO;
+		len = 1 + buf[0];
+	} else {
+		len = last->len - pec;
+	}
+	if (pec && msg_pec(crc, last, len) != last->buf[len])
+		return -EBADMSG;
+
+	/* Move the received data where i2c_smbus_access() would put it */
+	switch (size) {
+	case I2C_SMBUS_BYTE:
+	case I2C_SMBUS_BYTE_DATA:
+		buf[0] = rbuf[0];
+		break;
+	case I2C_SMBUS_WORD_DATA:
+	case I2C_SMBUS_PROC_CALL:
+		word = rbuf[0] | (rbuf[1] << 8);
+		memcpy(buf, &word, sizeof(word));
+		break;
+	}
+
+	return 0;
+}
+
+__s32 i2c_smbus_xfer(int file, __u16 addr, __u16 flags, char read_write,
+		     __u8 command, int size, union i2c_smbus_data *data)
+{
+	struct timespec start;
+	__s32 err;
+
+	if (i2c_trace_flags & I2C_TRACE_REPLAY)
+		return i2c_trace_replay(file, addr, read_write, command, size,
+					data);
+
+	if (i2c_trace_flags & (I2C_TRACE_LOG | I2C_TRACE_COUNT))
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	I2C_PROBE5(smbus_start, file, addr, read_write, command, size);
+	err = smbus_xfer_rdwr(file, addr, flags, read_write, command, size,
+			      data ? data->block : NULL, I2C_SMBUS_BLOCK_MAX);
+	I2C_PROBE6(smbus_done, file, addr, read_write, command, size, err);
+
+	if (i2c_trace_flags & I2C_TRACE_LOG)
+		i2c_trace_record(file, addr, &start, read_write, command,
+				 size, data, err);
+	if (i2c_trace_flags & I2C_TRACE_COUNT)
+		i2c_stats_account(file, addr, &start,
+				  i2c_smbus_data_len(read_write, size, data,
+						     err), err, 0);
+	return err;
+}
+
+
+__s32 i2c_xfer_write_quick(int file, __u16 addr, __u8 value)
+{
+	return i2c_smbus_xfer(file, addr, 0, value, 0, I2C_SMBUS_QUICK, NULL);
+}
+
+__s32 i2c_xfer_read_byte(int file, __u16 addr)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_READ, 0,
+			     I2C_SMBUS_BYTE, &data);
+	if (err < 0)
+		return err;
+
+	return 0x0FF & data.byte;
+}
+
+__s32 i2c_xfer_write_byte(int file, __u16 addr, __u8 value)
+{
+	return i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, value,
+			      I2C_SMBUS_BYTE, NULL);
+}
+
+__s32 i2c_xfer_read_byte_data(int file, __u16 addr, __u8 command)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_READ, command,
+			     I2C_SMBUS_BYTE_DATA, &data);
+	if (err < 0)
+		return err;
+
+	return 0x0FF & data.byte;
+}
+
+__s32 i2c_xfer_write_byte_data(int file, __u16 addr, __u8 command,
+			       __u8 value)
+{
+	union i2c_smbus_data data;
+	data.byte = value;
+	return i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			      I2C_SMBUS_BYTE_DATA, &data);
+}
+
+__s32 i2c_xfer_read_word_data(int file, __u16 addr, __u8 command)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_READ, command,
+			     I2C_SMBUS_WORD_DATA, &data);
+	if (err < 0)
+		return err;
+
+	return 0x0FFFF & data.word;
+}
+
+__s32 i2c_xfer_write_word_data(int file, __u16 addr, __u8 command,
+			       __u16 value)
+{
+	union i2c_smbus_data data;
+	data.word = value;
+	return i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			      I2C_SMBUS_WORD_DATA, &data);
+}
+
+__s32 i2c_xfer_process_call(int file, __u16 addr, __u8 command, __u16 value)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	data.word = value;
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			     I2C_SMBUS_PROC_CALL, &data);
+	if (err < 0)
+		return err;
+
+	return 0x0FFFF & data.word;
+}
+
+/* Returns the number of read bytes */
+__s32 i2c_xfer_read_block_data(int file, __u16 addr, __u8 command,
+			       __u8 *values)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_READ, command,
+			     I2C_SMBUS_BLOCK_DATA, &data);
+	if (err < 0)
+		return err;
+
+	memcpy(values, data.block + 1, data.block[0]);
+	return data.block[0];
+}
+
+__s32 i2c_xfer_write_block_data(int file, __u16 addr, __u8 command,
+				__u8 length, const __u8 *values)
+{
+	union i2c_smbus_data data;
+
+	if (length > I2C_SMBUS_BLOCK_MAX)
+		length = I2C_SMBUS_BLOCK_MAX;
+	memcpy(data.block + 1, values, length);
+	data.block[0] = length;
+	return i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			      I2C_SMBUS_BLOCK_DATA, &data);
+}
+
+/* Returns the number of read bytes */
+__s32 i2c_xfer_read_i2c_block_data(int file, __u16 addr, __u8 command,
+				   __u8 length, __u8 *values)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	if (length > I2C_SMBUS_BLOCK_MAX)
+		length = I2C_SMBUS_BLOCK_MAX;
+	data.block[0] = length;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_READ, command,
+			     I2C_SMBUS_I2C_BLOCK_DATA, &data);
+	if (err < 0)
+		return err;
+
+	memcpy(values, data.block + 1, data.block[0]);
+	return data.block[0];
+}
+
+__s32 i2c_xfer_write_i2c_block_data(int file, __u16 addr, __u8 command,
+				    __u8 length, const __u8 *values)
+{
+	union i2c_smbus_data data;
+
+	if (length > I2C_SMBUS_BLOCK_MAX)
+		length = I2C_SMBUS_BLOCK_MAX;
+	memcpy(data.block + 1, values, length);
+	data.block[0] = length;
+	return i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			      I2C_SMBUS_I2C_BLOCK_DATA, &data);
+}
+
+/* Returns the number of read bytes */
+__s32 i2c_xfer_block_process_call(int file, __u16 addr, __u8 command,
+				  __u8 length, __u8 *values)
+{
+	union i2c_smbus_data data;
+	int err;
+
+	if (length > I2C_SMBUS_BLOCK_MAX)
+		length = I2C_SMBUS_BLOCK_MAX;
+	memcpy(data.block + 1, values, length);
+	data.block[0] = length;
+
+	err = i2c_smbus_xfer(file, addr, 0, I2C_SMBUS_WRITE, command,
+			     I2C_SMBUS_BLOCK_PROC_CALL, &data);
+	if (err < 0)
+		return err;
+
+	memcpy(values, data.block + 1, data.block[0]);
+	return data.block[0];
+}
+
+/*
+ * SMBus 3.0 blocks, up to 255 bytes. These don't go through recording
+ * and replay, as trace records only hold 32-byte blocks.
+ */
+
+static __s32 smbus3_xfer_rdwr(int file, __u16 addr, __u16 flags,
+			      char read_write, __u8 command, int size,
+			      __u8 *buf)
+{
+	struct timespec start;
+	__s32 err;
+
+	if (i2c_trace_flags & I2C_TRACE_COUNT)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	err = smbus_xfer_rdwr(file, addr, flags, read_write, command, size,
+			      buf, I2C_SMBUS3_BLOCK_MAX);
+
+	if (i2c_trace_flags & I2C_TRACE_COUNT)
+		i2c_stats_account(file, addr, &start, buf[0] + 1, err, 0);
+	return err;
+}
+
+/* Returns the number of read bytes */
+__s32 i2c_xfer_read_block(int file, __u16 addr, __u16 flags, __u8 command,
+			  __u8 *values)
+{
+	__u8 buf[I2C_SMBUS3_BLOCK_MAX + 2];
+	int err;
+
+	err = smbus3_xfer_rdwr(file, addr, flags, I2C_SMBUS_READ, command,
+			       I2C_SMBUS_BLOCK_DATA, buf);
+	if (err < 0)
+		return err;
+
+	memcpy(values, buf + 1, buf[0]);
+	return buf[0];
+}
+
+__s32 i2c_xfer_write_block(int file, __u16 addr, __u16 flags, __u8 command,
+			   __u8 length, const __u8 *values)
+{
+	__u8 buf[I2C_SMBUS3_BLOCK_MAX + 2];
+
+	memcpy(buf + 1, values, length);
+	buf[0] = length;
+	return smbus3_xfer_rdwr(file, addr, flags, I2C_SMBUS_WRITE, command,
+				I2C_SMBUS_BLOCK_DATA, buf);
+}
+
+/* Returns the number of read bytes */
+__s32 i2c_xfer_block_process(int file, __u16 addr, __u16 flags,
+			     __u8 command, __u8 length, const __u8 *wvalues,
+			     __u8 *rvalues)
+{
+	__u8 buf[I2C_SMBUS3_BLOCK_MAX + 2];
+	int err;
+
+	memcpy(buf + 1, wvalues, length);
+	buf[0] = length;
+	err = smbus3_xfer_rdwr(file, addr, flags, I2C_SMBUS_WRITE, command,
+			       I2C_SMBUS_BLOCK_PROC_CALL, buf);
+	if (err < 0)
+		return err;
+
+	memcpy(rvalues, buf + 1, buf[0]);
+	return buf[0];
+}
+
+/*
+ * Bulk transfers, straight from and to the caller's buffer
+ */
+
+/* Read pairs (offset write, data read) packed in a single ioctl */
+#define BULK_PAIRS	(I2C_RDWR_IOCTL_MAX_MSGS / 2)
+
+__s32 i2c_xfer_read(int file, __u16 addr, __u16 flags, unsigned int offset,
+		    __u8 *values, unsigned int length)
+{
+	struct i2c_msg msgs[BULK_PAIRS * 2];
+	struct timespec start;
+	__u8 offs[BULK_PAIRS][2];
+	unsigned int done = 0, prev, chunk;
+	int n, err, retried, olen = flags & I2C_XFER_OFFSET16 ? 2 : 1;
+
+	if (length > 0x7fffffff)
+		return -EINVAL;
+	flags &= I2C_M_TEN;
+
+	while (done < length) {
+		prev = done;
+		for (n = 0; n < BULK_PAIRS && done < length; n++) {
+			chunk = length - done;
+			if (chunk > I2C_XFER_MSG_MAX)
+				chunk = I2C_XFER_MSG_MAX;
+
+			if (olen == 2) {
+				offs[n][0] = (offset + done) >> 8;
+				offs[n][1] = offset + done;
+			} else {
+				offs[n][0] = offset + done;
+			}
+			msgs[2 * n].addr = addr;
+			msgs[2 * n].flags = flags;
+			msgs[2 * n].len = olen;
+			msgs[2 * n].buf = offs[n];
+			msgs[2 * n + 1].addr = addr;
+			msgs[2 * n + 1].flags = flags | I2C_M_RD;
+			msgs[2 * n + 1].len = chunk;
+			msgs[2 * n + 1].buf = values + done;
+			done += chunk;
+		}
+
+		if (i2c_trace_flags & I2C_TRACE_COUNT)
+			clock_gettime(CLOCK_MONOTONIC, &start);
+
+		retried = 0;
+		err = i2c_rdwr(file, msgs, 2 * n);
+		if (err < 0) {
+			/* Too much for this adapter, fit it to its limits */
+			if (err == -EOPNOTSUPP) {
+				err = i2c_transfer_split(file, msgs, 2 * n);
+				retried = 1;
+			}
+		}
+
+		if (i2c_trace_flags & I2C_TRACE_COUNT)
+			i2c_stats_account(file, addr, &start, done - prev,
+					  err < 0 ? err : 0, retried);
+		if (err < 0)
+			return err;
+	}
+
+	return done;
+}
+
+__s32 i2c_xfer_write(int file, __u16 addr, __u16 flags, __u8 *buf,
+		     unsigned int length)
+{
+	struct i2c_msg msg;
+	struct timespec start;
+	int err, retried = 0;
+
+	if (length > I2C_XFER_MSG_MAX)
+		return -EINVAL;
+
+	if (i2c_trace_flags & I2C_TRACE_COUNT)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	msg.addr = addr;
+	msg.flags = flags & I2C_M_TEN;
+	msg.len = length;
+	msg.buf = buf;
+	err = i2c_rdwr(file, &msg, 1);
+	if (err < 0) {
+		if (err == -EOPNOTSUPP) {
+			err = i2c_transfer_split(file, &msg, 1);
+			retried = 1;
+		}
+	}
+
+	if (i2c_trace_flags & I2C_TRACE_COUNT)
+		i2c_stats_account(file, addr, &start, length,
+				  err < 0 ? err : 0, retried);
+	if (err < 0)
+		return err;
+
+	return length;
+}
@@ -14,7 +14,7 @@ DISTUTILS := \
 	cd $(PY_SMBUS_DIR) && \
 	$(PYTHON) setup.py
 
-all-python: $(INCLUDE_DIR)/i2c/smbus.h
+all-python: $(INCLUDE_DIR)/i2c/smbus.h $(LIB_DIR)/$(LIB_SHBASENAME)
 	$(DISTUTILS) build
 
 clean-python:
@@ -0,0 +1,505 @@
+/*
+    i2cconfig.c - Apply a register configuration to I2C chips
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/busses.h>
+#include <i2c/smbus.h>
+#include "i2cbusses.h"
+#include "util.h"
+#include "regset.h"
+#include "../version.h"
+
+static void help(void) __attribute__ ((noreturn));
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: i2cconfig [-f] [-y] [-n] [-r] [-a] [-c] [-v] CONFIG-FILE\n"
+		"  CONFIG-FILE lines are one of:\n"
+		"    I2CBUS CHIP-ADDRESS ENTRY ...\n"
+		"    delay MILLISECONDS\n"
+		"  ENTRY is DATA-ADDRESS=VALUE[/MASK][:MODE], MODE is b or w\n"
+		"  -n only shows which registers would be written\n"
+		"  -r reads back all written registers\n"
+		"  -a lets contiguous registers be written at once\n"
+		"  -c lets the writes to a chip go in one transfer, without stops\n"
+		"  -v lists each register written\n");
+	exit(1);
+}
+
+/*
+ * The configuration is a sequence of steps. Within a step, entries are
+ * grouped per chip, in order of first appearance; steps are separated by
+ * delays, which are honored between them.
+ */
+struct chip {
+	int bus, address;
+	struct regset_entry *entries;
+	int n, max;
+};
+
+struct step {
+	struct chip *chips;
+	int nchips;
+	long delay_us;		/* before the next step */
+};
+
+struct config {
+	struct step *steps;
+	int nsteps;
+};
+
+struct handle {
+	int bus;
+	int file;
+	unsigned long funcs;
+	char filename[20];
+};
+
+static void *grow(void *p, int n, int *max, size_t size)
+{
+	void *new_p;
+
+	if (n < *max)
+		return p;
+	new_p = realloc(p, (*max ? 2 * *max : 8) * size);
+	if (!new_p) {
+		fprintf(stderr, "Error: Out of memory!\n");
+		exit(1);
+	}
+	*max = *max ? 2 * *max : 8;
+	return new_p;
+}
+
+static struct step *new_step(struct config *cfg)
+{
+	struct step *step;
+
+	cfg->steps = realloc(cfg->steps, (cfg->nsteps + 1) *
+			     sizeof(*cfg->steps));
+	if (!cfg->steps) {
+		fprintf(stderr, "Error: Out of memory!\n");
+		exit(1);
+	}
+	step = &cfg->steps[cfg->nsteps++];
+	memset(step, 0, sizeof(*step));
+	return step;
+}
+
+static struct chip *get_chip(struct step *step, int bus, int address)
+{
+	struct chip *chip;
+	int i;
+
+	for (i = 0; i < step->nchips; i++)
+		if (step->chips[i].bus == bus
+		 && step->chips[i].address == address)
+			return &step->chips[i];
+
+	step->chips = realloc(step->chips, (step->nchips + 1) *
+			      sizeof(*step->chips));
+	if (!step->chips) {
+		fprintf(stderr, "Error: Out of memory!\n");
+		exit(1);
+	}
+	chip = &step->chips[step->nchips++];
+	memset(chip, 0, sizeof(*chip));
+	chip->bus = bus;
+	chip->address = address;
+	return chip;
+}
+
+static int add_entry(struct chip *chip, const char *s, const char *where)
+{
+	struct regset_entry *entry;
+	int i;
+
+	chip->entries = grow(chip->entries, chip->n, &chip->max,
+			     sizeof(*chip->entries));
+	entry = &chip->entries[chip->n];
+	if (regset_parse_entry(s, I2C_SMBUS_BYTE_DATA, entry)) {
+		fprintf(stderr, "Error: %s: Invalid entry '%s'\n", where, s);
+		return -1;
+	}
+
+	/* Values are read once per step, so each register only once too */
+	for (i = 0; i < chip->n; i++) {
+		if (chip->entries[i].daddress == entry->daddress) {
+			fprintf(stderr, "Error: %s: Register 0x%02x of %d-%04x "
+				"set twice without a delay in between\n", where,
+				entry->daddress, chip->bus, chip->address);
+			return -1;
+		}
+	}
+
+	chip->n++;
+	return 0;
+}
+
+static int read_config(const char *filename, struct config *cfg)
+{
+	char line[1024], where[256], *tok, *save, *end;
+	struct step *step;
+	struct chip *chip;
+	int lineno = 0, bus, address, res = 0;
+	double delay;
+	FILE *f;
+
+	f = fopen(filename, "r");
+	if (!f) {
+		fprintf(stderr, "Error: Can't open %s: %s\n", filename,
+			strerror(errno));
+		return -1;
+	}
+
+	memset(cfg, 0, sizeof(*cfg));
+	step = new_step(cfg);
+
+	while (!res && fgets(line, sizeof(line), f)) {
+		lineno++;
+		snprintf(where, sizeof(where), "%s:%d", filename, lineno);
+		tok = strchr(line, '#');
+		if (tok)
+			*tok = '\0';
+
+		tok = strtok_r(line, " \t\r\n", &save);
+		if (!tok)
+			continue;
+
+		if (!strcmp(tok, "delay")) {
+			tok = strtok_r(NULL, " \t\r\n", &save);
+			delay = tok ? strtod(tok, &end) : -1;
+			if (!tok || *end || delay < 0
+			 || strtok_r(NULL, " \t\r\n", &save)) {
+				fprintf(stderr, "Error: %s: Invalid delay\n",
+					where);
+				res = -1;
+				break;
+			}
+			step->delay_us += delay * 1000;
+			continue;
+		}
+
+		bus = i2c_lookup_i2c_bus(tok);
+		tok = strtok_r(NULL, " \t\r\n", &save);
+		address = tok ? i2c_parse_i2c_address(tok) : -1;
+		if (bus < 0 || address < 0) {
+			fprintf(stderr, "Error: %s: Invalid bus or chip "
+				"address\n", where);
+			res = -1;
+			break;
+		}
+
+		/* Anything after a delay belongs to the next step */
+		if (step->delay_us)
+			step = new_step(cfg);
+		chip = get_chip(step, bus, address);
+		while (!res && (tok = strtok_r(NULL, " \t\r\n", &save)))
+			res = add_entry(chip, tok, where);
+	}
+	fclose(f);
+
+	return res;
+}
+
+static struct handle *get_handle(struct handle *handles, int nhandles,
+				 int bus)
+{
+	int i;
+
+	for (i = 0; i < nhandles; i++)
+		if (handles[i].bus == bus)
+			return &handles[i];
+	return NULL;
+}
+
+static int check_funcs(unsigned long funcs, const struct chip *chip)
+{
+	int i;
+
+	/* Values are always read, to skip needless writes */
+	for (i = 0; i < chip->n; i++) {
+		if (chip->entries[i].size == I2C_SMBUS_WORD_DATA
+		 && !(funcs & I2C_FUNC_SMBUS_READ_WORD_DATA)) {
+			fprintf(stderr, MISSING_FUNC_FMT, "SMBus read word");
+			return -1;
+		}
+		if (chip->entries[i].size == I2C_SMBUS_BYTE_DATA
+		 && !(funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)) {
+			fprintf(stderr, MISSING_FUNC_FMT, "SMBus read byte");
+			return -1;
+		}
+	}
+
+	return regset_check_funcs(funcs, chip->entries, chip->n, 0);
+}
+
+/* Open each bus once, and check that it can do what we will ask */
+static struct handle *open_busses(const struct config *cfg, int *nhandles)
+{
+	struct handle *handles = NULL, *h;
+	int max = 0, s, c;
+
+	*nhandles = 0;
+	for (s = 0; s < cfg->nsteps; s++) {
+		for (c = 0; c < cfg->steps[s].nchips; c++) {
+			const struct chip *chip = &cfg->steps[s].chips[c];
+
+			h = get_handle(handles, *nhandles, chip->bus);
+			if (!h) {
+				handles = grow(handles, *nhandles, &max,
+					       sizeof(*handles));
+				h = &handles[(*nhandles)++];
+				h->bus = chip->bus;
+				h->file = i2c_open_i2c_dev(chip->bus,
+							   h->filename,
+							   sizeof(h->filename),
+							   0);
+				if (h->file < 0
+				 || i2c_get_functionality(h->file,
+							  &h->funcs) < 0)
+					exit(1);
+			}
+
+			if (check_funcs(h->funcs, chip))
+				exit(1);
+		}
+	}
+
+	return handles;
+}
+
+static int confirm(const char *filename, const struct config *cfg)
+{
+	int dont = 0, s, c, nchips = 0, nregs = 0;
+
+	fprintf(stderr, "WARNING! This program can confuse your I2C "
+		"bus, cause data loss and worse!\n");
+
+	for (s = 0; s < cfg->nsteps; s++) {
+		for (c = 0; c < cfg->steps[s].nchips; c++) {
+			const struct chip *chip = &cfg->steps[s].chips[c];
+
+			if (chip->address >= 0x50 && chip->address <= 0x57)
+				dont = 1;
+			nchips++;
+			nregs += chip->n;
+		}
+	}
+
+	if (dont)
+		fprintf(stderr, "DANGEROUS! Writing to a serial "
+			"EEPROM on a memory DIMM\nmay render your "
+			"memory USELESS and make your system "
+			"UNBOOTABLE!\n");
+
+	fprintf(stderr, "I will apply configuration %s,\nsetting up to %d "
+		"registers in %d chip groups.\n", filename, nregs, nchips);
+
+	fprintf(stderr, "Continue? [%s] ", dont ? "y/N" : "Y/n");
+	fflush(stderr);
+	if (!user_ack(!dont)) {
+		fprintf(stderr, "Aborting on user request.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+/* Drop the entries which already have the right value */
+static int minimal_writes(struct chip *chip, struct regset_entry *writes)
+{
+	int i, n = 0;
+
+	for (i = 0; i < chip->n; i++)
+		if (chip->entries[i].value != chip->entries[i].oldvalue)
+			writes[n++] = chip->entries[i];
+	return n;
+}
+
+static void show_writes(const struct chip *chip,
+			const struct regset_entry *writes, int n)
+{
+	int i, width;
+
+	for (i = 0; i < n; i++) {
+		width = writes[i].size == I2C_SMBUS_WORD_DATA ? 4 : 2;
+		printf("%d-%04x: 0x%02x 0x%0*x -> 0x%0*x\n", chip->bus,
+		       chip->address, writes[i].daddress, width,
+		       writes[i].oldvalue, width, writes[i].value);
+	}
+}
+
+static int run_step(struct step *step, struct handle *handles, int nhandles,
+		    int force, int flags, int dryrun, int readback,
+		    int verbose, int *nread, int *nwritten)
+{
+	struct regset_entry *writes;
+	struct handle *h;
+	int c, n, res, bad = 0;
+
+	/* Read all current values first */
+	for (c = 0; c < step->nchips; c++) {
+		struct chip *chip = &step->chips[c];
+
+		h = get_handle(handles, nhandles, chip->bus);
+		if (i2c_set_slave_addr(h->file, chip->address, force))
+			return -1;
+		res = regset_fetch(h->file, chip->address, h->funcs, flags,
+				   chip->entries, chip->n, 1);
+		if (res < chip->n) {
+			fprintf(stderr, "Error: Read of %d-%04x register "
+				"0x%02x failed\n", chip->bus, chip->address,
+				chip->entries[res].daddress);
+			return -1;
+		}
+		*nread += chip->n;
+	}
+
+	/* Then write what differs, one chip at a time */
+	for (c = 0; c < step->nchips; c++) {
+		struct chip *chip = &step->chips[c];
+
+		writes = malloc(chip->n * sizeof(*writes));
+		if (!writes) {
+			fprintf(stderr, "Error: Out of memory!\n");
+			return -1;
+		}
+		n = minimal_writes(chip, writes);
+		if (verbose || dryrun)
+			show_writes(chip, writes, n);
+		if (dryrun || !n) {
+			*nwritten += n;
+			free(writes);
+			continue;
+		}
+
+		h = get_handle(handles, nhandles, chip->bus);
+		if (i2c_set_slave_addr(h->file, chip->address, force)) {
+			free(writes);
+			return -1;
+		}
+		res = regset_write(h->file, chip->address, h->funcs, flags,
+				   writes, n);
+		*nwritten += res;
+		if (res < n) {
+			fprintf(stderr, "Error: Write to %d-%04x register "
+				"0x%02x failed\n", chip->bus, chip->address,
+				writes[res].daddress);
+			free(writes);
+			return -1;
+		}
+		if (readback)
+			bad += regset_verify(h->file, chip->address, h->funcs,
+					     flags, writes, n);
+		free(writes);
+	}
+
+	return bad;
+}
+
+static void sleep_us(long us)
+{
+	struct timespec ts;
+
+	ts.tv_sec = us / 1000000;
+	ts.tv_nsec = us % 1000000 * 1000;
+	while (nanosleep(&ts, &ts) < 0 && errno == EINTR)
+		;
+}
+
+int main(int argc, char *argv[])
+{
+	int flags = 0, rflags = 0;
+	int force = 0, yes = 0, version = 0, dryrun = 0, readback = 0;
+	int verbose = 0;
+	int nhandles, s, res = 0, bad = 0, nread = 0, nwritten = 0;
+	struct handle *handles;
+	struct config cfg;
+
+	/* handle (optional) flags first */
+	while (1+flags < argc && argv[1+flags][0] == '-') {
+		switch (argv[1+flags][1]) {
+		case 'V': version = 1; break;
+		case 'f': force = 1; break;
+		case 'y': yes = 1; break;
+		case 'n': dryrun = 1; break;
+		case 'r': readback = 1; break;
+		case 'a': rflags |= REGSET_AUTOINC; break;
+		case 'c': rflags |= REGSET_BATCH; break;
+		case 'v': verbose = 1; break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[1+flags]);
+			help();
+		}
+		flags++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2cconfig version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc != flags + 2)
+		help();
+
+	if (read_config(argv[flags+1], &cfg))
+		exit(1);
+
+	handles = open_busses(&cfg, &nhandles);
+
+	if (!yes && !dryrun && !confirm(argv[flags+1], &cfg))
+		exit(0);
+
+	for (s = 0; s < cfg.nsteps; s++) {
+		res = run_step(&cfg.steps[s], handles, nhandles, force,
+			       rflags, dryrun, readback, verbose, &nread,
+			       &nwritten);
+		if (res < 0)
+			break;
+		bad += res;
+		if (!dryrun && cfg.steps[s].delay_us)
+			sleep_us(cfg.steps[s].delay_us);
+	}
+
+	for (s = 0; s < nhandles; s++)
+		close(handles[s].file);
+
+	if (res < 0)
+		exit(1);
+
+	printf("%d registers checked, %d %s\n", nread, nwritten,
+	       dryrun ? "to write" : "written");
+	if (bad) {
+		fprintf(stderr, "Error: %d registers failed readback\n", bad);
+		exit(2);
+	}
+
+	exit(0);
+}
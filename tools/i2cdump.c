@@ -270,7 +270,7 @@ int main(int argc, char *argv[])
 		exit(1);
 
 	if (pec) {
-		if (ioctl(file, I2C_PEC, 1) < 0) {
+		if (i2c_set_pec(file, 1) < 0) {
 			fprintf(stderr, "Error: Could not set PEC: %s\n",
 				strerror(errno));
 			exit(1);
@@ -29,12 +29,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <time.h>
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <i2c/busses.h>
 #include <i2c/smbus.h>
 #include "i2cbusses.h"
 #include "util.h"
+#include "regset.h"
 #include "../version.h"
 
 static void help(void) __attribute__ ((noreturn));
@@ -42,28 +44,25 @@ static void help(void) __attribute__ ((noreturn));
 static void help(void)
 {
 	fprintf(stderr,
-		"Usage: i2cget [-f] [-y] I2CBUS CHIP-ADDRESS [DATA-ADDRESS [MODE]]\n"
+		"Usage: i2cget [-f] [-y] [-n COUNT [-i INTERVAL]] I2CBUS CHIP-ADDRESS\n"
+		"              [DATA-ADDRESS [MODE]]\n"
 		"  I2CBUS is an integer or an I2C bus name\n"
 		"  ADDRESS is an integer (0x03 - 0x77)\n"
+		"  DATA-ADDRESS is an integer (0x00 - 0xff), or a comma-separated list\n"
+		"    of integers and ranges (first-last), each optionally followed by\n"
+		"    :MODE to override MODE for it; one value is printed per line\n"
 		"  MODE is one of:\n"
 		"    b (read byte data, default)\n"
 		"    w (read word data)\n"
 		"    c (write byte/read byte)\n"
-		"    Append p for SMBus PEC\n");
+		"    Append p for SMBus PEC\n"
+		"  -n reads COUNT samples, printed one per line with a timestamp\n"
+		"  -i sets the sampling period in milliseconds (default: no delay)\n");
 	exit(1);
 }
 
-static int check_funcs(int file, int size, int daddress, int pec)
+static int check_funcs(unsigned long funcs, int size, int daddress, int pec)
 {
-	unsigned long funcs;
-
-	/* check adapter functionality */
-	if (ioctl(file, I2C_FUNCS, &funcs) < 0) {
-		fprintf(stderr, "Error: Could not get the adapter "
-			"functionality matrix: %s\n", strerror(errno));
-		return -1;
-	}
-
 	switch (size) {
 	case I2C_SMBUS_BYTE:
 		if (!(funcs & I2C_FUNC_SMBUS_READ_BYTE)) {
@@ -101,10 +100,11 @@ static int check_funcs(int file, int size, int daddress, int pec)
 	return 0;
 }
 
-static int confirm(const char *filename, int address, int size, int daddress,
-		   int pec)
+static int confirm(const char *filename, int address, int size,
+		   const struct regset_entry *regs, int nregs, const char *dlist, int pec)
 {
-	int dont = 0;
+	int daddress = regs[0].daddress;
+	int dont = 0, i;
 
 	fprintf(stderr, "WARNING! This program can confuse your I2C "
 		"bus, cause data loss and worse!\n");
@@ -119,7 +119,10 @@ static int confirm(const char *filename, int address, int size, int daddress,
 		return 0;
 	}
 
-	if (size == I2C_SMBUS_BYTE && daddress >= 0 && pec) {
+	for (i = 0; i < nregs; i++)
+		if (regs[i].size == I2C_SMBUS_BYTE && regs[i].daddress >= 0)
+			break;
+	if (i < nregs && pec) {
 		fprintf(stderr, "WARNING! All I2C chips and some SMBus chips "
 			"will interpret a write\nbyte command with PEC as a"
 			"write byte data command, effectively writing a\n"
@@ -129,15 +132,17 @@ static int confirm(const char *filename, int address, int size, int daddress,
 
 	fprintf(stderr, "I will read from device file %s, chip "
 		"address 0x%02x, ", filename, address);
-	if (daddress < 0)
+	if (dlist)
+		fprintf(stderr, "%d data addresses\n%s", nregs, dlist);
+	else if (daddress < 0)
 		fprintf(stderr, "current data\naddress");
 	else
 		fprintf(stderr, "data address\n0x%02x", daddress);
-	fprintf(stderr, ", using %s.\n",
+	fprintf(stderr, ", using %s%s.\n",
 		size == I2C_SMBUS_BYTE ? (daddress < 0 ?
 		"read byte" : "write byte/read byte") :
 		size == I2C_SMBUS_BYTE_DATA ? "read byte data" :
-		"read word data");
+		"read word data", dlist ? " unless specified otherwise" : "");
 	if (pec)
 		fprintf(stderr, "PEC checking enabled.\n");
 
@@ -151,15 +156,216 @@ static int confirm(const char *filename, int address, int size, int daddress,
 	return 1;
 }
 
-int main(int argc, char *argv[])
+static int parse_mode(char mode)
 {
+	switch (mode) {
+	case 'b': return I2C_SMBUS_BYTE_DATA;
+	case 'w': return I2C_SMBUS_WORD_DATA;
+	case 'c': return I2C_SMBUS_BYTE;
+	}
+	return -1;
+}
+
+static int parse_daddress(const char *arg, char **end)
+{
+	long daddress;
+
+	daddress = strtol(arg, end, 0);
+	if (*end == arg || daddress < 0 || daddress > 0xff)
+		return -1;
+	return daddress;
+}
+
+/*
+ * Parse a DATA-ADDRESS list such as "0x00-0x03,0x10:w,0x20". Registers
+ * without an explicit mode use size. Returns the number of registers,
+ * or -1 if the list is invalid.
+ */
+static int parse_regs(const char *arg, int size, struct regset_entry **regs)
+{
+	const char *p = arg;
 	char *end;
-	int res, i2cbus, address, size, file;
-	int daddress;
+	int first, last, rsize, nregs = 0, max = 0;
+
+	*regs = NULL;
+	for (;;) {
+		first = last = parse_daddress(p, &end);
+		if (first < 0)
+			goto fail;
+		if (*end == '-') {
+			last = parse_daddress(end + 1, &end);
+			if (last < first)
+				goto fail;
+		}
+
+		rsize = size;
+		if (*end == ':') {
+			rsize = parse_mode(end[1]);
+			if (rsize < 0)
+				goto fail;
+			end += 2;
+		}
+
+		for (; first <= last; first++) {
+			if (nregs == max) {
+				struct regset_entry *new_regs;
+
+				max = max ? 2 * max : 16;
+				new_regs = realloc(*regs, max * sizeof(**regs));
+				if (!new_regs)
+					goto fail;
+				*regs = new_regs;
+			}
+			(*regs)[nregs].daddress = first;
+			(*regs)[nregs].size = rsize;
+			(*regs)[nregs].value = 0;
+			(*regs)[nregs].vmask = 0;
+			(*regs)[nregs].oldvalue = -1;
+			nregs++;
+		}
+
+		if (!*end)
+			return nregs;
+		if (*end != ',')
+			goto fail;
+		p = end + 1;
+	}
+
+fail:
+	free(*regs);
+	*regs = NULL;
+	return -1;
+}
+
+static void print_error(const struct regset_entry *reg, const char *dlist)
+{
+	if (dlist)
+		fprintf(stderr, "Error: Read of data address 0x%02x failed\n",
+			reg->daddress);
+	else
+		fprintf(stderr, "Error: Read failed\n");
+}
+
+static __u64 timespec_ns(const struct timespec *ts)
+{
+	return (__u64)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static void ns_timespec(__u64 ns, struct timespec *ts)
+{
+	ts->tv_sec = ns / 1000000000;
+	ts->tv_nsec = ns % 1000000000;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	__u64 x = *(const __u64 *)a, y = *(const __u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * Read all registers count times, on a fixed schedule if interval_ns is
+ * set. Deadlines are absolute, so the time spent reading and printing
+ * doesn't make the schedule drift. If a sample is so late that the next
+ * deadline is already gone, the deadlines in between are skipped and
+ * reported as missed. Each sample is printed on its own line, starting
+ * with its time in seconds since the first sample. Returns 0 on success,
+ * or -1 if a read failed.
+ */
+static int run_samples(int file, int address, unsigned long funcs,
+		       int rflags, const struct regset_entry *regs, int nregs,
+		       int *values,
+		       const char *dlist, unsigned long count,
+		       __u64 interval_ns)
+{
+	struct timespec ts;
+	__u64 origin, deadline, now, *late = NULL, total = 0;
+	unsigned long i, missed = 0;
+	int res, j;
+
+	if (interval_ns) {
+		late = malloc(count * sizeof(*late));
+		if (!late) {
+			fprintf(stderr, "Error: No memory for statistics\n");
+			return -1;
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	origin = deadline = timespec_ns(&ts);
+
+	for (i = 0; i < count; i++) {
+		if (i && interval_ns) {
+			deadline += interval_ns;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			now = timespec_ns(&ts);
+			while (deadline + interval_ns <= now) {
+				deadline += interval_ns;
+				missed++;
+			}
+			ns_timespec(deadline, &ts);
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+					NULL);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		now = timespec_ns(&ts);
+		if (late) {
+			late[i] = now > deadline ? now - deadline : 0;
+			total += late[i];
+		}
+
+		res = regset_read(file, address, funcs, rflags, regs, nregs,
+				  values);
+		if (res < nregs) {
+			print_error(&regs[res], dlist);
+			free(late);
+			return -1;
+		}
+
+		now -= origin;
+		printf("%llu.%06llu", (unsigned long long)now / 1000000000,
+		       (unsigned long long)now % 1000000000 / 1000);
+		for (j = 0; j < nregs; j++)
+			printf(" 0x%0*x",
+			       regs[j].size == I2C_SMBUS_WORD_DATA ? 4 : 2,
+			       values[j]);
+		printf("\n");
+	}
+	fflush(stdout);
+
+	/* Statistics go to stderr, so that stdout only holds samples */
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = timespec_ns(&ts) - origin;
+	fprintf(stderr, "%lu samples in %.3f s, %lu missed deadlines\n",
+		count, now / 1000000000.0, missed);
+	if (late) {
+		qsort(late, count, sizeof(*late), cmp_u64);
+		fprintf(stderr, "jitter (us): min %.1f, mean %.1f, p99 %.1f, "
+			"max %.1f\n", late[0] / 1000.0, total / 1000.0 / count,
+			late[(count * 99 + 99) / 100 - 1] / 1000.0,
+			late[count - 1] / 1000.0);
+		free(late);
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int res, i2cbus, address, size, file, i;
 	char filename[20];
+	unsigned long funcs;
+	struct regset_entry *regs;
+	int nregs, *values, rflags;
+	const char *dlist = NULL;
 	int pec = 0;
 	int flags = 0;
 	int force = 0, yes = 0, version = 0;
+	unsigned long count = 0;
+	double interval = 0;
+	char *end;
 
 	/* handle (optional) flags first */
 	while (1+flags < argc && argv[1+flags][0] == '-') {
@@ -167,6 +373,26 @@ int main(int argc, char *argv[])
 		case 'V': version = 1; break;
 		case 'f': force = 1; break;
 		case 'y': yes = 1; break;
+		case 'n':
+			if (2+flags >= argc)
+				help();
+			count = strtoul(argv[2+flags], &end, 0);
+			if (*end || count == 0) {
+				fprintf(stderr, "Error: Count invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		case 'i':
+			if (2+flags >= argc)
+				help();
+			interval = strtod(argv[2+flags], &end);
+			if (*end || interval < 0) {
+				fprintf(stderr, "Error: Interval invalid!\n");
+				help();
+			}
+			flags++;
+			break;
 		default:
 			fprintf(stderr, "Error: Unsupported option "
 				"\"%s\"!\n", argv[1+flags]);
@@ -184,6 +410,11 @@ int main(int argc, char *argv[])
 	if (argc < flags + 3)
 		help();
 
+	if (interval && !count) {
+		fprintf(stderr, "Error: Interval requires a count!\n");
+		help();
+	}
+
 	i2cbus = i2c_lookup_i2c_bus(argv[flags+1]);
 	if (i2cbus < 0)
 		help();
@@ -192,69 +423,85 @@ int main(int argc, char *argv[])
 	if (address < 0)
 		help();
 
-	if (argc > flags + 3) {
-		size = I2C_SMBUS_BYTE_DATA;
-		daddress = strtol(argv[flags+3], &end, 0);
-		if (*end || daddress < 0 || daddress > 0xff) {
-			fprintf(stderr, "Error: Data address invalid!\n");
+	size = argc > flags + 3 ? I2C_SMBUS_BYTE_DATA : I2C_SMBUS_BYTE;
+	if (argc > flags + 4) {
+		size = parse_mode(argv[flags+4][0]);
+		if (size < 0) {
+			fprintf(stderr, "Error: Invalid mode!\n");
 			help();
 		}
-	} else {
-		size = I2C_SMBUS_BYTE;
-		daddress = -1;
+		pec = argv[flags+4][1] == 'p';
 	}
 
-	if (argc > flags + 4) {
-		switch (argv[flags+4][0]) {
-		case 'b': size = I2C_SMBUS_BYTE_DATA; break;
-		case 'w': size = I2C_SMBUS_WORD_DATA; break;
-		case 'c': size = I2C_SMBUS_BYTE; break;
-		default:
-			fprintf(stderr, "Error: Invalid mode!\n");
+	if (argc > flags + 3) {
+		dlist = argv[flags+3];
+		nregs = parse_regs(dlist, size, &regs);
+		if (nregs < 0) {
+			fprintf(stderr, "Error: Data address invalid!\n");
 			help();
 		}
-		pec = argv[flags+4][1] == 'p';
+		/* A single plain data address, keep the classic behavior */
+		if (!strpbrk(dlist, ",-:"))
+			dlist = NULL;
+	} else {
+		regs = malloc(sizeof(*regs));
+		if (!regs)
+			exit(1);
+		regs[0].daddress = -1;
+		regs[0].size = size;
+		regs[0].value = 0;
+		regs[0].vmask = 0;
+		regs[0].oldvalue = -1;
+		nregs = 1;
 	}
 
 	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
 	if (file < 0
-	 || check_funcs(file, size, daddress, pec)
-	 || i2c_set_slave_addr(file, address, force))
+	 || i2c_get_functionality(file, &funcs) < 0)
+		exit(1);
+	for (i = 0; i < nregs; i++)
+		if (check_funcs(funcs, regs[i].size, regs[i].daddress, pec))
+			exit(1);
+	if (i2c_set_slave_addr(file, address, force))
 		exit(1);
 
-	if (!yes && !confirm(filename, address, size, daddress, pec))
+	if (!yes && !confirm(filename, address, size, regs, nregs, dlist, pec))
 		exit(0);
 
-	if (pec && ioctl(file, I2C_PEC, 1) < 0) {
+	if (pec && i2c_set_pec(file, 1) < 0) {
 		fprintf(stderr, "Error: Could not set PEC: %s\n",
 			strerror(errno));
 		close(file);
 		exit(1);
 	}
 
-	switch (size) {
-	case I2C_SMBUS_BYTE:
-		if (daddress >= 0) {
-			res = i2c_smbus_write_byte(file, daddress);
-			if (res < 0)
-				fprintf(stderr, "Warning - write failed\n");
-		}
-		res = i2c_smbus_read_byte(file);
-		break;
-	case I2C_SMBUS_WORD_DATA:
-		res = i2c_smbus_read_word_data(file, daddress);
-		break;
-	default: /* I2C_SMBUS_BYTE_DATA */
-		res = i2c_smbus_read_byte_data(file, daddress);
+	values = malloc(nregs * sizeof(*values));
+	if (!values) {
+		close(file);
+		exit(1);
 	}
+
+	rflags = pec ? REGSET_PEC : 0;
+	if (count) {
+		res = run_samples(file, address, funcs, rflags, regs, nregs,
+				  values, dlist, count,
+				  (__u64)(interval * 1000000));
+		close(file);
+		exit(res ? 2 : 0);
+	}
+	res = regset_read(file, address, funcs, rflags, regs, nregs, values);
 	close(file);
 
-	if (res < 0) {
-		fprintf(stderr, "Error: Read failed\n");
+	for (i = 0; i < res; i++)
+		printf("0x%0*x\n", regs[i].size == I2C_SMBUS_WORD_DATA ? 4 : 2,
+		       values[i]);
+
+	if (res < nregs) {
+		print_error(&regs[res], dlist);
 		exit(2);
 	}
 
-	printf("0x%0*x\n", size == I2C_SMBUS_WORD_DATA ? 4 : 2, res);
-
+	free(values);
+	free(regs);
 	exit(0);
 }
@@ -0,0 +1,298 @@
+/*
+    i2cload.c - A user-space program to write an i2cdump back to a chip.
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    Based on i2c-stub-from-dump:
+    Copyright (C) 2007-2012  Jean Delvare <jdelvare@suse.de>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/busses.h>
+#include <i2c/smbus.h>
+#include "i2cbusses.h"
+#include "util.h"
+#include "../version.h"
+
+static void help(void) __attribute__ ((noreturn));
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: i2cload [-f] [-y] I2CBUS CHIP-ADDRESS DUMP-FILE\n"
+		"  I2CBUS is an integer or an I2C bus name\n"
+		"  ADDRESS is an integer (0x03 - 0x77)\n"
+		"  DUMP-FILE is the output of i2cdump in byte or word mode\n");
+	exit(1);
+}
+
+/* Register values found in the dump, -1 if not present */
+struct dump {
+	int byte[256];
+	int word[256];
+	int bytes, words;
+};
+
+static int hex_digit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	c = tolower(c);
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+/*
+ * Parse count values of width hex digits each, as found after the
+ * offset in an i2cdump line. XX (unreadable) values are stored as -1.
+ * Returns 0 on success, -1 if the line doesn't have the expected format.
+ */
+static int parse_values(const char *s, int count, int width, int *values)
+{
+	int i, j, d;
+
+	for (i = 0; i < count; i++) {
+		if (*s++ != ' ')
+			return -1;
+		values[i] = 0;
+		for (j = 0; j < width; j++, s++) {
+			if (*s == 'X' || *s == 'x') {
+				values[i] = -1;
+				continue;
+			}
+			d = hex_digit(*s);
+			if (d < 0)
+				return -1;
+			if (values[i] >= 0)
+				values[i] = (values[i] << 4) | d;
+		}
+	}
+
+	return 0;
+}
+
+/* Same line formats as accepted by i2c-stub-from-dump */
+static void parse_line(const char *s, struct dump *dump)
+{
+	int hi, lo, offset, i;
+	int values[16];
+	const char *p;
+
+	hi = hex_digit(s[0]);
+	lo = hex_digit(s[1]);
+	if (hi < 0 || (lo != 0 && lo != 8))
+		return;
+	offset = hi << 4 | lo;
+
+	p = s + 2;
+	if (*p == ' ')
+		p++;
+	if (*p != ':' && *p != '|')
+		return;
+	p++;
+
+	if (lo == 0 && !parse_values(p, 16, 2, values)) {
+		/* Byte dump */
+		for (i = 0; i < 16; i++) {
+			if (values[i] < 0)
+				continue;
+			if (dump->byte[offset + i] < 0)
+				dump->bytes++;
+			dump->byte[offset + i] = values[i];
+		}
+	} else if (!parse_values(p, 8, 4, values)) {
+		/* Word dump */
+		for (i = 0; i < 8; i++) {
+			if (values[i] < 0)
+				continue;
+			if (dump->word[offset + i] < 0)
+				dump->words++;
+			dump->word[offset + i] = values[i];
+		}
+	}
+}
+
+static int read_dump(const char *filename, struct dump *dump)
+{
+	char line[256];
+	FILE *f;
+	int i;
+
+	for (i = 0; i < 256; i++)
+		dump->byte[i] = dump->word[i] = -1;
+	dump->bytes = dump->words = 0;
+
+	f = fopen(filename, "r");
+	if (!f) {
+		fprintf(stderr, "Error: Can't open %s: %s\n", filename,
+			strerror(errno));
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+		parse_line(line, dump);
+	fclose(f);
+
+	return 0;
+}
+
+static int check_funcs(int file, const struct dump *dump)
+{
+	unsigned long funcs;
+
+	/* check adapter functionality */
+	if (i2c_get_functionality(file, &funcs) < 0)
+		return -1;
+
+	if (dump->bytes && !(funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus write byte");
+		return -1;
+	}
+	if (dump->words && !(funcs & I2C_FUNC_SMBUS_WRITE_WORD_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus write word");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int confirm(const char *filename, int address, const struct dump *dump)
+{
+	int dont = 0;
+
+	fprintf(stderr, "WARNING! This program can confuse your I2C "
+		"bus, cause data loss and worse!\n");
+
+	if (address >= 0x50 && address <= 0x57) {
+		fprintf(stderr, "DANGEROUS! Writing to a serial "
+			"EEPROM on a memory DIMM\nmay render your "
+			"memory USELESS and make your system "
+			"UNBOOTABLE!\n");
+		dont++;
+	}
+
+	fprintf(stderr, "I will write %d byte and %d word values to device "
+		"file %s,\nchip address 0x%02x.\n", dump->bytes, dump->words,
+		filename, address);
+
+	fprintf(stderr, "Continue? [%s] ", dont ? "y/N" : "Y/n");
+	fflush(stderr);
+	if (!user_ack(!dont)) {
+		fprintf(stderr, "Aborting on user request.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	int i2cbus, address, file, i, res;
+	char filename[20];
+	int flags = 0;
+	int force = 0, yes = 0, version = 0;
+	struct dump dump;
+
+	/* handle (optional) flags first */
+	while (1+flags < argc && argv[1+flags][0] == '-') {
+		switch (argv[1+flags][1]) {
+		case 'V': version = 1; break;
+		case 'f': force = 1; break;
+		case 'y': yes = 1; break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[1+flags]);
+			help();
+		}
+		flags++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2cload version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc != flags + 4)
+		help();
+
+	i2cbus = i2c_lookup_i2c_bus(argv[flags+1]);
+	if (i2cbus < 0)
+		help();
+
+	address = i2c_parse_i2c_address(argv[flags+2]);
+	if (address < 0)
+		help();
+
+	if (read_dump(argv[flags+3], &dump))
+		exit(1);
+	if (!dump.bytes && !dump.words) {
+		fprintf(stderr, "Only garbage found in dump file %s\n",
+			argv[flags+3]);
+		exit(2);
+	}
+
+	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
+	if (file < 0
+	 || check_funcs(file, &dump)
+	 || i2c_set_slave_addr(file, address, force))
+		exit(1);
+
+	if (!yes && !confirm(filename, address, &dump))
+		exit(0);
+
+	for (i = 0; i < 256; i++) {
+		if (dump.byte[i] < 0)
+			continue;
+		res = i2c_smbus_write_byte_data(file, i, dump.byte[i]);
+		if (res < 0) {
+			fprintf(stderr, "Error: Write to register 0x%02x "
+				"failed: %s\n", i, strerror(-res));
+			close(file);
+			exit(1);
+		}
+	}
+
+	for (i = 0; i < 256; i++) {
+		if (dump.word[i] < 0)
+			continue;
+		res = i2c_smbus_write_word_data(file, i, dump.word[i]);
+		if (res < 0) {
+			fprintf(stderr, "Error: Write to register 0x%02x "
+				"failed: %s\n", i, strerror(-res));
+			close(file);
+			exit(1);
+		}
+	}
+	close(file);
+
+	if (dump.bytes)
+		printf("%d byte values written to %d-%04x\n", dump.bytes,
+		       i2cbus, address);
+	if (dump.words)
+		printf("%d word values written to %d-%04x\n", dump.words,
+		       i2cbus, address);
+
+	exit(0);
+}
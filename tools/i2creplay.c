@@ -0,0 +1,261 @@
+/*
+    i2creplay.c - Play recorded SMBus traffic back into i2c-stub chips
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/busses.h>
+#include <i2c/smbus.h>
+#include <i2c/trace.h>
+#include "i2cbusses.h"
+#include "util.h"
+#include "../version.h"
+
+static void help(void) __attribute__ ((noreturn));
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: i2creplay [-f] [-y] [-n] [-a ADDRESS] [-b BUS] I2CBUS "
+		"TRACE-FILE\n"
+		"  I2CBUS is an integer or an I2C bus name\n"
+		"  TRACE-FILE was recorded by setting I2C_RECORD=TRACE-FILE\n"
+		"  -a limits the replay to one chip address (0x03 - 0x77)\n"
+		"  -b replays the transactions recorded on bus number BUS\n"
+		"    (default: the bus of the first one)\n"
+		"  -n writes all values as fast as possible, ignoring timing\n");
+	exit(1);
+}
+
+static int check_funcs(int file)
+{
+	unsigned long funcs;
+
+	/* check adapter functionality */
+	if (i2c_get_functionality(file, &funcs) < 0)
+		return -1;
+
+	if (!(funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus write byte");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int confirm(const char *filename, const char *trace, int address)
+{
+	fprintf(stderr, "WARNING! This program can confuse your I2C "
+		"bus, cause data loss and worse!\n");
+	fprintf(stderr, "I will write the values read in trace %s\n"
+		"to device file %s", trace, filename);
+	if (address >= 0)
+		fprintf(stderr, ", chip address 0x%02x", address);
+	fprintf(stderr, ".\nThis is only meant for i2c-stub chips!\n");
+
+	fprintf(stderr, "Continue? [y/N] ");
+	fflush(stderr);
+	if (!user_ack(0)) {
+		fprintf(stderr, "Aborting on user request.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+/* Only successful reads of these types tell what the chip contained */
+static int replayable(const struct i2c_trace_record *rec)
+{
+	if (rec->read_write != I2C_SMBUS_READ || rec->result < 0
+	 || !rec->len || rec->addr == I2C_TRACE_UNKNOWN)
+		return 0;
+
+	switch (rec->size) {
+	case I2C_SMBUS_BYTE_DATA:
+	case I2C_SMBUS_WORD_DATA:
+	case I2C_SMBUS_I2C_BLOCK_BROKEN:
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Write the value a chip answered in rec, so that the stub answers it too */
+static int replay_record(int file, const struct i2c_trace_record *rec)
+{
+	switch (rec->size) {
+	case I2C_SMBUS_BYTE_DATA:
+		return i2c_smbus_write_byte_data(file, rec->command,
+						 rec->data[0]);
+	case I2C_SMBUS_WORD_DATA:
+		return i2c_smbus_write_word_data(file, rec->command,
+						 rec->data[0] |
+						 rec->data[1] << 8);
+	case I2C_SMBUS_I2C_BLOCK_BROKEN:
+	case I2C_SMBUS_I2C_BLOCK_DATA:
+		return i2c_smbus_write_i2c_block_data(file, rec->command,
+						      rec->data[0],
+						      rec->data + 1);
+	}
+
+	return 0;
+}
+
+static void sleep_until(__u64 ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec = ns / 1000000000;
+	ts.tv_nsec = ns % 1000000000;
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+int main(int argc, char *argv[])
+{
+	char *end;
+	int i2cbus, address = -1, bus = -1, file, res;
+	char filename[20];
+	int flags = 0;
+	int force = 0, yes = 0, version = 0, notime = 0;
+	int current = -1, count = 0, skipped = 0;
+	struct i2c_trace *trace;
+	struct i2c_trace_record rec;
+	struct timespec now;
+	__u64 first = 0, origin;
+
+	/* handle (optional) flags first */
+	while (1+flags < argc && argv[1+flags][0] == '-') {
+		switch (argv[1+flags][1]) {
+		case 'V': version = 1; break;
+		case 'f': force = 1; break;
+		case 'y': yes = 1; break;
+		case 'n': notime = 1; break;
+		case 'a':
+			if (2+flags >= argc)
+				help();
+			address = strtol(argv[2+flags], &end, 0);
+			if (*end || address < 0x03 || address > 0x77) {
+				fprintf(stderr, "Error: Chip address invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		case 'b':
+			if (2+flags >= argc)
+				help();
+			bus = strtol(argv[2+flags], &end, 0);
+			if (*end || bus < 0 || bus >= I2C_TRACE_UNKNOWN) {
+				fprintf(stderr, "Error: Recorded bus invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[1+flags]);
+			help();
+		}
+		flags++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2creplay version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc != flags + 3)
+		help();
+
+	i2cbus = i2c_lookup_i2c_bus(argv[flags+1]);
+	if (i2cbus < 0)
+		help();
+
+	trace = i2c_trace_open(argv[flags+2]);
+	if (!trace) {
+		fprintf(stderr, "Error: Could not open trace %s: %s\n",
+			argv[flags+2], strerror(errno));
+		exit(1);
+	}
+
+	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
+	if (file < 0 || check_funcs(file))
+		exit(1);
+
+	if (!yes && !confirm(filename, argv[flags+2], address))
+		exit(0);
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	origin = (__u64)now.tv_sec * 1000000000 + now.tv_nsec;
+
+	while ((res = i2c_trace_read(trace, &rec)) > 0) {
+		if (!replayable(&rec))
+			continue;
+		if (address >= 0 && rec.addr != address)
+			continue;
+		/* Chips on different buses may share addresses */
+		if (bus < 0)
+			bus = rec.bus;
+		if (rec.bus != bus) {
+			skipped++;
+			continue;
+		}
+
+		if (!count)
+			first = rec.timestamp;
+		else if (!notime)
+			sleep_until(origin + rec.timestamp - first);
+
+		if (rec.addr != current) {
+			if (i2c_set_slave_addr(file, rec.addr, force))
+				exit(1);
+			current = rec.addr;
+		}
+
+		res = replay_record(file, &rec);
+		if (res < 0) {
+			fprintf(stderr, "Error: Write to 0x%02x register 0x%02x "
+				"failed: %s\n", rec.addr, rec.command,
+				strerror(-res));
+			exit(1);
+		}
+		count++;
+	}
+	close(file);
+	i2c_trace_close(trace);
+
+	if (res < 0) {
+		fprintf(stderr, "Error: Trace %s is corrupted\n",
+			argv[flags+2]);
+		exit(1);
+	}
+
+	printf("%d values replayed\n", count);
+	if (skipped)
+		printf("%d values recorded on other buses skipped, "
+		       "see option -b\n", skipped);
+	exit(0);
+}
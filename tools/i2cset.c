@@ -32,6 +32,7 @@
 #include <i2c/smbus.h>
 #include "i2cbusses.h"
 #include "util.h"
+#include "regset.h"
 #include "../version.h"
 
 static void help(void) __attribute__ ((noreturn));
@@ -40,8 +41,14 @@ static void help(void)
 {
 	fprintf(stderr,
 		"Usage: i2cset [-f] [-y] [-m MASK] [-r] I2CBUS CHIP-ADDRESS DATA-ADDRESS [VALUE] ... [MODE]\n"
+		"       i2cset [-f] [-y] [-r] [-a] [-c] [-l LIST-FILE] I2CBUS CHIP-ADDRESS [ENTRY] ... [MODE]\n"
 		"  I2CBUS is an integer or an I2C bus name\n"
 		"  ADDRESS is an integer (0x03 - 0x77)\n"
+		"  ENTRY is DATA-ADDRESS=VALUE[/MASK][:MODE], LIST-FILE (- for stdin,\n"
+		"    requires -y) holds entries separated by white space, and # starts\n"
+		"    a comment; ENTRY MODE can only be b or w, -a lets contiguous\n"
+		"    registers be written at once, -c lets all writes go in one\n"
+		"    transfer, without stops between them\n"
 		"  MODE is one of:\n"
 		"    c (byte, no value)\n"
 		"    b (byte data, default)\n"
@@ -155,6 +162,224 @@ static int confirm(const char *filename, int address, int size, int daddress,
 	return 1;
 }
 
+static int add_entry(const char *s, int size, struct regset_entry **entries,
+		     int *n, int *max)
+{
+	if (*n == *max) {
+		struct regset_entry *new_entries;
+
+		*max = *max ? 2 * *max : 64;
+		new_entries = realloc(*entries, *max * sizeof(**entries));
+		if (!new_entries) {
+			fprintf(stderr, "Error: Out of memory!\n");
+			return -1;
+		}
+		*entries = new_entries;
+	}
+
+	if (regset_parse_entry(s, size, &(*entries)[*n])) {
+		fprintf(stderr, "Error: Invalid entry '%s'!\n", s);
+		return -1;
+	}
+	(*n)++;
+	return 0;
+}
+
+static int read_list(const char *filename, int size,
+		     struct regset_entry **entries, int *n, int *max)
+{
+	char line[256], *tok, *save;
+	FILE *f;
+	int res = 0;
+
+	if (!strcmp(filename, "-"))
+		f = stdin;
+	else
+		f = fopen(filename, "r");
+	if (!f) {
+		fprintf(stderr, "Error: Can't open %s: %s\n", filename,
+			strerror(errno));
+		return -1;
+	}
+
+	while (!res && fgets(line, sizeof(line), f)) {
+		tok = strchr(line, '#');
+		if (tok)
+			*tok = '\0';
+		for (tok = strtok_r(line, " \t\r\n", &save); tok && !res;
+		     tok = strtok_r(NULL, " \t\r\n", &save))
+			res = add_entry(tok, size, entries, n, max);
+	}
+
+	if (f != stdin)
+		fclose(f);
+	return res;
+}
+
+static int confirm_list(const char *filename, int address,
+			const struct regset_entry *entries, int n, int pec)
+{
+	int dont = 0, i;
+
+	fprintf(stderr, "WARNING! This program can confuse your I2C "
+		"bus, cause data loss and worse!\n");
+
+	if (address >= 0x50 && address <= 0x57) {
+		fprintf(stderr, "DANGEROUS! Writing to a serial "
+			"EEPROM on a memory DIMM\nmay render your "
+			"memory USELESS and make your system "
+			"UNBOOTABLE!\n");
+		dont++;
+	}
+
+	fprintf(stderr, "I will write to device file %s, chip address "
+		"0x%02x, %d registers:", filename, address, n);
+	for (i = 0; i < n; i++)
+		fprintf(stderr, "%s0x%02x=0x%0*x%s", i % 6 ? " " : "\n",
+			entries[i].daddress,
+			entries[i].size == I2C_SMBUS_WORD_DATA ? 4 : 2,
+			entries[i].value, entries[i].vmask ? " (masked)" : "");
+	fprintf(stderr, "\n");
+	if (pec)
+		fprintf(stderr, "PEC checking enabled.\n");
+
+	fprintf(stderr, "Continue? [%s] ", dont ? "y/N" : "Y/n");
+	fflush(stderr);
+	if (!user_ack(!dont)) {
+		fprintf(stderr, "Aborting on user request.\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Write a list of registers over a single open file. Nothing is written
+ * until all entries are parsed and all masked registers are read, and
+ * the readback, if requested, is done in one pass at the end.
+ */
+static void run_list(int argc, char *argv[], int flags, const char *listfile,
+		     int force, int yes, int readback, int rflags)
+{
+	int i2cbus, address, file, res, i, nargs, masked = 0;
+	int size = I2C_SMBUS_BYTE_DATA, pec = 0;
+	struct regset_entry *entries = NULL;
+	int n = 0, max = 0;
+	unsigned long funcs;
+	char filename[20];
+	const char *mode;
+
+	if (argc < flags + 3)
+		help();
+
+	i2cbus = i2c_lookup_i2c_bus(argv[flags+1]);
+	if (i2cbus < 0)
+		help();
+
+	address = i2c_parse_i2c_address(argv[flags+2]);
+	if (address < 0)
+		help();
+
+	/* Optional default mode comes last */
+	nargs = argc - flags - 3;
+	mode = argv[argc-1];
+	if (nargs && !strchr(mode, '=')) {
+		if ((mode[0] != 'b' && mode[0] != 'w')
+		 || (mode[1] && (mode[1] != 'p' || mode[2]))) {
+			fprintf(stderr, "Error: Invalid mode '%s'!\n", mode);
+			help();
+		}
+		size = mode[0] == 'w' ? I2C_SMBUS_WORD_DATA :
+		       I2C_SMBUS_BYTE_DATA;
+		pec = mode[1] == 'p';
+		nargs--;
+	}
+
+	for (i = 0; i < nargs; i++)
+		if (add_entry(argv[flags+3+i], size, &entries, &n, &max))
+			help();
+	if (listfile && read_list(listfile, size, &entries, &n, &max))
+		exit(1);
+	if (!n) {
+		fprintf(stderr, "Error: No register to write!\n");
+		help();
+	}
+
+	if (pec)
+		rflags |= REGSET_PEC;
+
+	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
+	if (file < 0
+	 || i2c_get_functionality(file, &funcs) < 0
+	 || regset_check_funcs(funcs, entries, n, rflags)
+	 || i2c_set_slave_addr(file, address, force))
+		exit(1);
+
+	if (!yes && !confirm_list(filename, address, entries, n, pec))
+		exit(0);
+
+	if (pec && i2c_set_pec(file, 1) < 0) {
+		fprintf(stderr, "Error: Could not set PEC: %s\n",
+			strerror(errno));
+		close(file);
+		exit(1);
+	}
+
+	res = regset_fetch(file, address, funcs, rflags, entries, n, 0);
+	if (res < n) {
+		fprintf(stderr, "Error: Failed to read old value of 0x%02x\n",
+			entries[res].daddress);
+		close(file);
+		exit(1);
+	}
+
+	if (!yes) {
+		for (i = 0; i < n; i++) {
+			int width = entries[i].size == I2C_SMBUS_WORD_DATA ?
+				    4 : 2;
+
+			if (!entries[i].vmask)
+				continue;
+			masked++;
+			fprintf(stderr, "Old value 0x%0*x, write mask "
+				"0x%0*x: Will write 0x%0*x to register "
+				"0x%02x\n", width, entries[i].oldvalue,
+				width, entries[i].vmask, width,
+				entries[i].value, entries[i].daddress);
+		}
+		if (masked) {
+			fprintf(stderr, "Continue? [Y/n] ");
+			fflush(stderr);
+			if (!user_ack(1)) {
+				fprintf(stderr, "Aborting on user request.\n");
+				close(file);
+				exit(0);
+			}
+		}
+	}
+
+	res = regset_write(file, address, funcs, rflags, entries, n);
+	if (res < n) {
+		fprintf(stderr, "Error: Write failed at 0x%02x, %d of %d "
+			"registers written\n", entries[res].daddress, res, n);
+		close(file);
+		exit(1);
+	}
+
+	if (!readback) { /* We're done */
+		close(file);
+		exit(0);
+	}
+
+	res = regset_verify(file, address, funcs, rflags, entries, n);
+	close(file);
+
+	if (!res)
+		printf("%d values written, readback matched\n", n);
+
+	exit(0);
+}
+
 int main(int argc, char *argv[])
 {
 	char *end;
@@ -164,7 +389,8 @@ int main(int argc, char *argv[])
 	char filename[20];
 	int pec = 0;
 	int flags = 0;
-	int force = 0, yes = 0, version = 0, readback = 0;
+	int force = 0, yes = 0, version = 0, readback = 0, rflags = 0;
+	const char *listfile = NULL;
 	unsigned char block[I2C_SMBUS_BLOCK_MAX];
 	int len;
 
@@ -180,6 +406,13 @@ int main(int argc, char *argv[])
 			flags++;
 			break;
 		case 'r': readback = 1; break;
+		case 'a': rflags |= REGSET_AUTOINC; break;
+		case 'c': rflags |= REGSET_BATCH; break;
+		case 'l':
+			if (2+flags < argc)
+				listfile = argv[2+flags];
+			flags++;
+			break;
 		default:
 			fprintf(stderr, "Error: Unsupported option "
 				"\"%s\"!\n", argv[1+flags]);
@@ -194,6 +427,22 @@ int main(int argc, char *argv[])
 		exit(0);
 	}
 
+	if (listfile || (argc > flags + 3 && strchr(argv[flags+3], '='))) {
+		if (maskp) {
+			fprintf(stderr, "Error: Use DATA-ADDRESS=VALUE/MASK "
+				"to mask list entries!\n");
+			help();
+		}
+		/* The confirmation would be read from the list itself */
+		if (listfile && !strcmp(listfile, "-") && !yes) {
+			fprintf(stderr, "Error: A list from standard input "
+				"requires -y!\n");
+			help();
+		}
+		run_list(argc, argv, flags, listfile, force, yes, readback,
+			 rflags);
+	}
+
 	if (argc < flags + 4)
 		help();
 
@@ -360,7 +609,7 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	if (pec && ioctl(file, I2C_PEC, 1) < 0) {
+	if (pec && i2c_set_pec(file, 1) < 0) {
 		fprintf(stderr, "Error: Could not set PEC: %s\n",
 			strerror(errno));
 		close(file);
@@ -391,7 +640,7 @@ int main(int argc, char *argv[])
 	}
 
 	if (pec) {
-		if (ioctl(file, I2C_PEC, 0) < 0) {
+		if (i2c_set_pec(file, 0) < 0) {
 			fprintf(stderr, "Error: Could not clear PEC: %s\n",
 				strerror(errno));
 			close(file);
@@ -0,0 +1,425 @@
+/*
+    i2ctop.c - Live view of I2C bus activity of all processes
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/types.h>
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <i2c/stats.h>
+#include <i2c/shmstats.h>
+#include "../version.h"
+
+#define SHM_DIR		"/dev/shm"
+
+static void help(void) __attribute__ ((noreturn));
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: i2ctop [-b] [-p] [-a] [-i SECONDS] [-n COUNT] [-f HZ]\n"
+		"  Shows the I2C transactions of processes started with "
+		"I2C_STATS_SHM=1\n"
+		"  -b batch mode, no screen refresh\n"
+		"  -p one line per process, instead of per chip\n"
+		"  -a also show idle chips\n"
+		"  -i interval between updates (default 1 second)\n"
+		"  -n number of updates before exiting\n"
+		"  -f bus clock frequency, instead of the one of each bus\n");
+	exit(1);
+}
+
+/* Counters of one process for one chip, between two updates */
+struct entry {
+	int pid;
+	int bus;
+	int addr;
+	int seen;
+	struct i2c_shm_counters cur;
+	struct i2c_shm_counters prev;
+};
+
+/* What gets displayed, per chip or per process and chip */
+struct row {
+	int bus;
+	int addr;
+	int pid;
+	int procs;
+	struct i2c_stats delta;
+};
+
+static struct entry *entries;
+static int nr_entries, max_entries;
+static unsigned int freq;	/* from -f, 0 to ask the library */
+
+static struct entry *get_entry(int pid, int bus, int addr)
+{
+	struct entry *e;
+	int i;
+
+	for (i = 0; i < nr_entries; i++) {
+		e = &entries[i];
+		if (e->pid == pid && e->bus == bus && e->addr == addr)
+			return e;
+	}
+
+	if (nr_entries == max_entries) {
+		max_entries = max_entries ? 2 * max_entries : 64;
+		e = realloc(entries, max_entries * sizeof(*e));
+		if (!e) {
+			fprintf(stderr, "Error: Out of memory\n");
+			exit(1);
+		}
+		entries = e;
+	}
+
+	e = &entries[nr_entries++];
+	memset(e, 0, sizeof(*e));
+	e->pid = pid;
+	e->bus = bus;
+	e->addr = addr;
+	return e;
+}
+
+/* Read the counters of all live processes, returns how many there are */
+static int scan(void)
+{
+	struct i2c_shm_stats *shm;
+	struct i2c_shm_counters c;
+	struct entry *e;
+	struct dirent *de;
+	char path[sizeof(SHM_DIR) + 256];
+	int i, pid, bus, addr, procs = 0;
+	DIR *dir;
+
+	for (i = 0; i < nr_entries; i++)
+		entries[i].seen = 0;
+
+	dir = opendir(SHM_DIR);
+	if (!dir) {
+		fprintf(stderr, "Error: Could not open %s: %s\n", SHM_DIR,
+			strerror(errno));
+		exit(1);
+	}
+
+	while ((de = readdir(dir)) != NULL) {
+		snprintf(path, sizeof(path), "%s/%s", SHM_DIR, de->d_name);
+		if (strncmp(path, I2C_SHM_PREFIX, strlen(I2C_SHM_PREFIX)))
+			continue;
+		shm = i2c_shm_open(path);
+		if (!shm)
+			continue;
+
+		/* Left behind by a process which was killed */
+		pid = i2c_shm_pid(shm);
+		if (kill(pid, 0) < 0 && errno == ESRCH) {
+			i2c_shm_close(shm);
+			continue;
+		}
+
+		procs++;
+		for (i = 0; i < I2C_SHM_SLOTS; i++) {
+			if (i2c_shm_read(shm, i, &bus, &addr, &c) != 1)
+				continue;
+			e = get_entry(pid, bus, addr);
+			e->prev = e->cur;
+			e->cur = c;
+			e->seen = 1;
+		}
+		i2c_shm_close(shm);
+	}
+	closedir(dir);
+
+	/* Forget about processes which are gone */
+	for (i = 0; i < nr_entries; ) {
+		if (entries[i].seen) {
+			i++;
+			continue;
+		}
+		entries[i] = entries[--nr_entries];
+	}
+
+	return procs;
+}
+
+static void add_delta(struct i2c_stats *d, const struct entry *e)
+{
+	int i;
+
+	d->transactions += e->cur.transactions - e->prev.transactions;
+	d->bytes += e->cur.bytes - e->prev.bytes;
+	d->failed += e->cur.failed - e->prev.failed;
+	d->total_ns += e->cur.total_ns - e->prev.total_ns;
+	d->wire_bits += e->cur.wire_bits - e->prev.wire_bits;
+	if (e->cur.max_ns > d->max_ns)
+		d->max_ns = e->cur.max_ns;
+	for (i = 0; i < I2C_STATS_BUCKETS; i++)
+		d->latency[i] += e->cur.latency[i] - e->prev.latency[i];
+}
+
+static int row_cmp(const void *a, const void *b)
+{
+	const struct row *ra = a, *rb = b;
+
+	if (ra->delta.total_ns != rb->delta.total_ns)
+		return ra->delta.total_ns < rb->delta.total_ns ? 1 : -1;
+	if (ra->bus != rb->bus)
+		return ra->bus - rb->bus;
+	if (ra->addr != rb->addr)
+		return ra->addr - rb->addr;
+	return ra->pid - rb->pid;
+}
+
+/* Group entries per chip (pid -1) or per process and chip */
+static struct row *make_rows(int per_process, int *nr_rows)
+{
+	struct row *rows;
+	int i, j, n = 0;
+
+	rows = calloc(nr_entries ? nr_entries : 1, sizeof(*rows));
+	if (!rows) {
+		fprintf(stderr, "Error: Out of memory\n");
+		exit(1);
+	}
+
+	for (i = 0; i < nr_entries; i++) {
+		const struct entry *e = &entries[i];
+		int pid = per_process ? e->pid : -1;
+
+		for (j = 0; j < n; j++) {
+			if (rows[j].bus == e->bus && rows[j].addr == e->addr
+			 && rows[j].pid == pid)
+				break;
+		}
+		if (j == n) {
+			rows[n].bus = e->bus;
+			rows[n].addr = e->addr;
+			rows[n].pid = pid;
+			n++;
+		}
+		rows[j].procs++;
+		add_delta(&rows[j].delta, e);
+	}
+
+	qsort(rows, n, sizeof(*rows), row_cmp);
+	*nr_rows = n;
+	return rows;
+}
+
+static void get_comm(int pid, char *comm, size_t size)
+{
+	char path[32];
+	FILE *f;
+
+	snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+	f = fopen(path, "r");
+	if (!f || !fgets(comm, size, f))
+		snprintf(comm, size, "?");
+	else
+		comm[strcspn(comm, "\n")] = '\0';
+	if (f)
+		fclose(f);
+}
+
+static void print_bus(int bus, const char *fmt)
+{
+	if (bus < 0)
+		printf(fmt, "?");
+	else {
+		char name[12];
+
+		snprintf(name, sizeof(name), "%d", bus);
+		printf(fmt, name);
+	}
+}
+
+/* Time the bits took on the wire, in ns */
+static double wire_ns(int bus, __u64 bits)
+{
+	return i2c_stats_wire_ns(bits, freq ? freq :
+				 i2c_get_bus_frequency(bus));
+}
+
+static void display(int procs, double interval, int per_process,
+		    int show_idle, int batch)
+{
+	struct row *rows, *buses;
+	int nr_rows, nr_buses = 0, i, j;
+	char comm[32];
+	double busy, wire;
+
+	rows = make_rows(per_process, &nr_rows);
+
+	/* Per bus totals */
+	buses = calloc(nr_rows ? nr_rows : 1, sizeof(*buses));
+	if (!buses) {
+		fprintf(stderr, "Error: Out of memory\n");
+		exit(1);
+	}
+	for (i = 0; i < nr_rows; i++) {
+		for (j = 0; j < nr_buses; j++)
+			if (buses[j].bus == rows[i].bus)
+				break;
+		if (j == nr_buses)
+			buses[nr_buses++].bus = rows[i].bus;
+		buses[j].delta.transactions += rows[i].delta.transactions;
+		buses[j].delta.failed += rows[i].delta.failed;
+		buses[j].delta.total_ns += rows[i].delta.total_ns;
+		buses[j].delta.wire_bits += rows[i].delta.wire_bits;
+	}
+
+	if (!batch)
+		printf("\033[H\033[2J");
+	printf("i2ctop - %d process%s, %.1f s interval\n\n", procs,
+	       procs == 1 ? "" : "es", interval);
+
+	for (j = 0; j < nr_buses; j++) {
+		busy = buses[j].delta.total_ns / (interval * 1e7);
+		print_bus(buses[j].bus, "i2c-%s:");
+		printf(" %8.1f trans/s %8.1f err/s %6.1f%% busy %6.1f%% wire "
+		       "at %u kHz\n",
+		       buses[j].delta.transactions / interval,
+		       buses[j].delta.failed / interval, busy,
+		       wire_ns(buses[j].bus, buses[j].delta.wire_bits)
+		       / (interval * 1e7),
+		       (freq ? freq : i2c_get_bus_frequency(buses[j].bus))
+		       / 1000);
+	}
+	printf("\n");
+
+	printf("BUS  ADDR   TRANS/s   BYTES/s   ERR/s  AVG us WIRE us  P99 us  "
+	       "MAX us  BUSY%%  WIRE%%  %s\n",
+	       per_process ? "PID   COMMAND" : "PROCS");
+	for (i = 0; i < nr_rows; i++) {
+		const struct i2c_stats *d = &rows[i].delta;
+
+		if (!d->transactions && !show_idle)
+			continue;
+
+		print_bus(rows[i].bus, "%-3s");
+		if (rows[i].addr == I2C_STATS_UNKNOWN)
+			printf("  ?   ");
+		else
+			printf("  0x%02x", rows[i].addr);
+		wire = wire_ns(rows[i].bus, d->wire_bits);
+		printf(" %9.1f %9.1f %7.1f %7llu %7.0f %7llu %7llu %6.1f %6.1f  ",
+		       d->transactions / interval, d->bytes / interval,
+		       d->failed / interval,
+		       d->transactions ? (unsigned long long)
+		       (d->total_ns / d->transactions / 1000) : 0ULL,
+		       d->transactions ? wire / d->transactions / 1000 : 0.0,
+		       (unsigned long long)i2c_stats_percentile(d, 99) / 1000,
+		       (unsigned long long)d->max_ns / 1000,
+		       d->total_ns / (interval * 1e7),
+		       wire / (interval * 1e7));
+		if (per_process) {
+			get_comm(rows[i].pid, comm, sizeof(comm));
+			printf("%-5d %s\n", rows[i].pid, comm);
+		} else {
+			printf("%d\n", rows[i].procs);
+		}
+	}
+	if (batch)
+		printf("\n");
+	fflush(stdout);
+
+	free(buses);
+	free(rows);
+}
+
+int main(int argc, char *argv[])
+{
+	char *end;
+	int flags = 0, version = 0, batch = 0, per_process = 0, show_idle = 0;
+	long count = -1;
+	double interval = 1.0;
+	struct timespec ts;
+	int procs;
+
+	/* handle (optional) flags first */
+	while (1+flags < argc && argv[1+flags][0] == '-') {
+		switch (argv[1+flags][1]) {
+		case 'V': version = 1; break;
+		case 'b': batch = 1; break;
+		case 'p': per_process = 1; break;
+		case 'a': show_idle = 1; break;
+		case 'i':
+			if (2+flags >= argc)
+				help();
+			interval = strtod(argv[2+flags], &end);
+			if (*end || interval < 0.1) {
+				fprintf(stderr, "Error: Interval invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		case 'n':
+			if (2+flags >= argc)
+				help();
+			count = strtol(argv[2+flags], &end, 0);
+			if (*end || count < 1) {
+				fprintf(stderr, "Error: Count invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		case 'f':
+			if (2+flags >= argc)
+				help();
+			freq = strtoul(argv[2+flags], &end, 0);
+			if (*end || freq < 1000) {
+				fprintf(stderr, "Error: Frequency invalid!\n");
+				help();
+			}
+			flags++;
+			break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[1+flags]);
+			help();
+		}
+		flags++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2ctop version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc != flags + 1)
+		help();
+
+	ts.tv_sec = (time_t)interval;
+	ts.tv_nsec = (long)((interval - ts.tv_sec) * 1e9);
+
+	/* The first scan is only the reference for the first update */
+	scan();
+	while (count < 0 || count--) {
+		nanosleep(&ts, NULL);
+		procs = scan();
+		display(procs, interval, per_process, show_idle, batch);
+	}
+
+	exit(0);
+}
@@ -0,0 +1,270 @@
+/*
+    i2ctrace.c - Convert libi2c traces to Chrome trace-event JSON
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <linux/i2c.h>
+#include <i2c/trace.h>
+#include "../version.h"
+
+static void help(void) __attribute__ ((noreturn));
+
+static void help(void)
+{
+	fprintf(stderr,
+		"Usage: i2ctrace [-t] [-o OUTPUT] TRACE-FILE\n"
+		"  TRACE-FILE was recorded by setting I2C_RECORD=TRACE-FILE or\n"
+		"    I2C_TIMELINE=TRACE-FILE\n"
+		"  -t one track per thread, instead of per chip address\n"
+		"  -o writes the JSON to OUTPUT instead of standard output\n");
+	exit(1);
+}
+
+static const char *size_names[] = {
+	[I2C_SMBUS_QUICK]		= "quick",
+	[I2C_SMBUS_BYTE]		= "byte",
+	[I2C_SMBUS_BYTE_DATA]		= "byte data",
+	[I2C_SMBUS_WORD_DATA]		= "word data",
+	[I2C_SMBUS_PROC_CALL]		= "process call",
+	[I2C_SMBUS_BLOCK_DATA]		= "block data",
+	[I2C_SMBUS_I2C_BLOCK_BROKEN]	= "i2c block data",
+	[I2C_SMBUS_BLOCK_PROC_CALL]	= "block process call",
+	[I2C_SMBUS_I2C_BLOCK_DATA]	= "i2c block data",
+};
+
+static const char *size_name(int size)
+{
+	if (size == I2C_TRACE_RDWR)
+		return "i2c transfer";
+	if (size < (int)(sizeof(size_names) / sizeof(size_names[0]))
+	 && size_names[size])
+		return size_names[size];
+	return "unknown";
+}
+
+/* Tracks which were already given a name */
+struct track {
+	int pid;
+	int tid;
+};
+
+static struct track *tracks;
+static int nr_tracks, max_tracks;
+static int nr_events;
+
+/* Opens a new JSON object, after a comma if needed */
+static void event_start(FILE *out)
+{
+	fprintf(out, nr_events++ ? ",\n{" : "{");
+}
+
+static int track_seen(int pid, int tid)
+{
+	struct track *t;
+	int i;
+
+	for (i = 0; i < nr_tracks; i++)
+		if (tracks[i].pid == pid && tracks[i].tid == tid)
+			return 1;
+
+	if (nr_tracks == max_tracks) {
+		max_tracks = max_tracks ? 2 * max_tracks : 64;
+		t = realloc(tracks, max_tracks * sizeof(*t));
+		if (!t) {
+			fprintf(stderr, "Error: Out of memory\n");
+			exit(1);
+		}
+		tracks = t;
+	}
+	tracks[nr_tracks].pid = pid;
+	tracks[nr_tracks].tid = tid;
+	nr_tracks++;
+	return 0;
+}
+
+static int rec_cmp(const void *a, const void *b)
+{
+	const struct i2c_trace_record *ra = a, *rb = b;
+
+	if (ra->timestamp != rb->timestamp)
+		return ra->timestamp < rb->timestamp ? -1 : 1;
+	/* Outer transactions first, so that nested ones show inside */
+	if (ra->duration != rb->duration)
+		return ra->duration > rb->duration ? -1 : 1;
+	return 0;
+}
+
+/* Adapters are processes, chip addresses or threads are threads */
+static void print_names(FILE *out, const struct i2c_trace_record *rec,
+			int tid, int per_thread)
+{
+	if (!track_seen(rec->bus, -1)) {
+		event_start(out);
+		fprintf(out, "\"ph\":\"M\",\"name\":\"process_name\","
+			"\"pid\":%d,\"args\":{\"name\":\"", rec->bus);
+		if (rec->bus == I2C_TRACE_UNKNOWN)
+			fprintf(out, "unknown bus\"}}");
+		else
+			fprintf(out, "i2c-%d\"}}", rec->bus);
+	}
+
+	if (track_seen(rec->bus, tid))
+		return;
+	event_start(out);
+	fprintf(out, "\"ph\":\"M\",\"name\":\"thread_name\","
+		"\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"", rec->bus, tid);
+	if (per_thread)
+		fprintf(out, "thread %d\"}}", tid);
+	else if (rec->addr == I2C_TRACE_UNKNOWN)
+		fprintf(out, "unknown address\"}}");
+	else
+		fprintf(out, "0x%02x\"}}", rec->addr);
+}
+
+static void print_event(FILE *out, const struct i2c_trace_record *rec,
+			__u64 origin, int per_thread)
+{
+	int i, tid;
+
+	tid = per_thread ? (int)rec->tid : rec->addr;
+	print_names(out, rec, tid, per_thread);
+
+	event_start(out);
+	fprintf(out, "\"ph\":\"X\",\"name\":\"%s %s\",\"cat\":\"%s\","
+		"\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+		rec->read_write == I2C_SMBUS_READ ? "read" : "write",
+		size_name(rec->size),
+		rec->size == I2C_TRACE_RDWR ? "i2c" : "smbus",
+		rec->bus, tid, (rec->timestamp - origin) / 1000.0,
+		rec->duration / 1000.0);
+	if (rec->result < 0)
+		fprintf(out, ",\"cname\":\"terrible\"");
+
+	fprintf(out, ",\"args\":{\"thread\":%u,\"fd\":%d",
+		rec->tid, rec->fd);
+	if (rec->addr != I2C_TRACE_UNKNOWN)
+		fprintf(out, ",\"address\":\"0x%02x\"", rec->addr);
+	if (rec->size != I2C_SMBUS_QUICK && rec->size != I2C_SMBUS_BYTE)
+		fprintf(out, ",\"command\":\"0x%02x\"", rec->command);
+	fprintf(out, ",\"result\":%d", rec->result);
+	if (rec->result < 0)
+		fprintf(out, ",\"error\":\"%s\"", strerror(-rec->result));
+	if (rec->len) {
+		fprintf(out, ",\"data\":\"");
+		for (i = 0; i < rec->len; i++)
+			fprintf(out, "%s%02x", i ? " " : "", rec->data[i]);
+		fprintf(out, "\"");
+	}
+	fprintf(out, "}}");
+}
+
+int main(int argc, char *argv[])
+{
+	int flags = 0, version = 0, per_thread = 0, i, res;
+	const char *output = NULL;
+	struct i2c_trace *trace;
+	struct i2c_trace_record *recs = NULL, *r;
+	int nr_recs = 0, max_recs = 0;
+	FILE *out = stdout;
+
+	/* handle (optional) flags first */
+	while (1+flags < argc && argv[1+flags][0] == '-') {
+		switch (argv[1+flags][1]) {
+		case 'V': version = 1; break;
+		case 't': per_thread = 1; break;
+		case 'o':
+			if (2+flags >= argc)
+				help();
+			output = argv[2+flags];
+			flags++;
+			break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[1+flags]);
+			help();
+		}
+		flags++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2ctrace version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc != flags + 2)
+		help();
+
+	trace = i2c_trace_open(argv[flags+1]);
+	if (!trace) {
+		fprintf(stderr, "Error: Could not open trace %s: %s\n",
+			argv[flags+1], strerror(errno));
+		exit(1);
+	}
+
+	/* Timelines are in completion order, events are sorted by start */
+	for (;;) {
+		if (nr_recs == max_recs) {
+			max_recs = max_recs ? 2 * max_recs : 1024;
+			r = realloc(recs, max_recs * sizeof(*r));
+			if (!r) {
+				fprintf(stderr, "Error: Out of memory\n");
+				exit(1);
+			}
+			recs = r;
+		}
+		res = i2c_trace_read(trace, &recs[nr_recs]);
+		if (res <= 0)
+			break;
+		nr_recs++;
+	}
+	i2c_trace_close(trace);
+	if (res < 0) {
+		fprintf(stderr, "Error: Trace %s is corrupted\n",
+			argv[flags+1]);
+		exit(1);
+	}
+	qsort(recs, nr_recs, sizeof(*recs), rec_cmp);
+
+	if (output) {
+		out = fopen(output, "w");
+		if (!out) {
+			fprintf(stderr, "Error: Could not open %s: %s\n",
+				output, strerror(errno));
+			exit(1);
+		}
+	}
+
+	fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	for (i = 0; i < nr_recs; i++)
+		print_event(out, &recs[i], recs[0].timestamp, per_thread);
+	fprintf(out, "\n]}\n");
+
+	if (fflush(out) || ferror(out) || (output && fclose(out))) {
+		fprintf(stderr, "Error: Could not write %s\n",
+			output ? output : "standard output");
+		exit(1);
+	}
+	free(recs);
+	free(tracks);
+
+	exit(0);
+}
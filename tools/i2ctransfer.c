@@ -28,9 +28,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <time.h>
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include "i2c/busses.h"
+#include "i2c/xfer.h"
 #include "i2cbusses.h"
 #include "util.h"
 #include "../version.h"
@@ -44,11 +46,13 @@ enum parse_state {
 #define PRINT_READ_BUF	(1 << 1)
 #define PRINT_WRITE_BUF	(1 << 2)
 #define PRINT_HEADER	(1 << 3)
+#define PRINT_ONE_LINE	(1 << 4)
 
 static void help(void)
 {
 	fprintf(stderr,
-		"Usage: i2ctransfer [-f] [-y] [-v] [-V] I2CBUS DESC [DATA] [DESC [DATA]]...\n"
+		"Usage: i2ctransfer [-f] [-y] [-v] [-V] [-o FILE] [-n COUNT [-i INTERVAL]] I2CBUS DESC [DATA] [DESC [DATA]]...\n"
+		"       i2ctransfer [-f] [-y] [-v] [-o FILE] -s SCRIPT I2CBUS\n"
 		"  I2CBUS is an integer or an I2C bus name\n"
 		"  DESC describes the transfer in the form: {r|w}LENGTH[@address]\n"
 		"    1) read/write-flag 2) LENGTH (range 0-65535) 3) I2C address (use last one if omitted)\n"
@@ -56,6 +60,14 @@ static void help(void)
 		"    = (keep value constant until LENGTH)\n"
 		"    + (increase value by 1 until LENGTH)\n"
 		"    - (decrease value by 1 until LENGTH)\n"
+		"  DATA can also be @file:PATH to take the remaining bytes of the message\n"
+		"    from a binary file, which must hold exactly that many bytes\n"
+		"  FILE receives the read data as raw binary (- for stdout)\n"
+		"  SCRIPT is a file (- for stdin, requires -y) with one DESC [DATA]...\n"
+		"    group per line, each line is sent as a separate transfer and prints\n"
+		"    one output line\n"
+		"  COUNT repeats the transfer and prints latency statistics, INTERVAL is the\n"
+		"    period between transfer starts in milliseconds (default: back-to-back)\n"
 		"\nExample (bus 0, read 8 byte at offset 0x64 from eeprom at 0x50):\n"
 		"  # i2ctransfer 0 w1@0x50 0x64 r8\n"
 		"Example (same eeprom, at offset 0x42 write 0xff 0xfe .. 0x00 ):\n"
@@ -78,30 +90,144 @@ static int check_funcs(int file)
 	return 0;
 }
 
+/*
+ * Output buffer for message data. Formatting large reads with one
+ * fprintf per byte is way slower than the transfer itself.
+ */
+struct out_buf {
+	FILE *output;
+	size_t len;
+	char data[4096];
+};
+
+static void out_flush(struct out_buf *out)
+{
+	fwrite(out->data, 1, out->len, out->output);
+	out->len = 0;
+}
+
+static void out_hex(struct out_buf *out, const __u8 *buf, __u32 len)
+{
+	static const char hex[] = "0123456789abcdef";
+	__u32 j;
+
+	for (j = 0; j < len; j++) {
+		char *p;
+
+		if (out->len + 5 > sizeof(out->data))
+			out_flush(out);
+		p = out->data + out->len;
+		p[0] = '0';
+		p[1] = 'x';
+		p[2] = hex[buf[j] >> 4];
+		p[3] = hex[buf[j] & 0x0f];
+		p[4] = ' ';
+		out->len += 5;
+	}
+}
+
+static void out_newline(struct out_buf *out)
+{
+	if (out->len == sizeof(out->data))
+		out_flush(out);
+	out->data[out->len++] = '\n';
+}
+
 static void print_msgs(struct i2c_msg *msgs, __u32 nmsgs, unsigned flags)
 {
-	__u32 i, j;
-	FILE *output = flags & PRINT_STDERR ? stderr : stdout;
+	__u32 i;
+	struct out_buf out;
+
+	out.output = flags & PRINT_STDERR ? stderr : stdout;
+	out.len = 0;
 
 	for (i = 0; i < nmsgs; i++) {
 		int read = !!(msgs[i].flags & I2C_M_RD);
 		int newline = !!(flags & PRINT_HEADER);
 
-		if (flags & PRINT_HEADER)
-			fprintf(output, "Msg %u: addr 0x%02x, %s, len %u",
+		if (flags & PRINT_HEADER) {
+			out_flush(&out);
+			fprintf(out.output, "Msg %u: addr 0x%02x, %s, len %u",
 				i, msgs[i].addr, read ? "read" : "write", msgs[i].len);
+		}
 		if (msgs[i].len &&
 		   (read == !!(flags & PRINT_READ_BUF) ||
 		   !read == !!(flags & PRINT_WRITE_BUF))) {
 			if (flags & PRINT_HEADER)
-				fprintf(output, ", buf ");
-			for (j = 0; j < msgs[i].len; j++)
-				fprintf(output, "0x%02x ", msgs[i].buf[j]);
+				fprintf(out.output, ", buf ");
+			out_hex(&out, msgs[i].buf, msgs[i].len);
 			newline = 1;
 		}
-		if (newline)
-			fprintf(output, "\n");
+		if (newline && !(flags & PRINT_ONE_LINE))
+			out_newline(&out);
 	}
+
+	/* In script mode, every transfer gets exactly one output line */
+	if (flags & PRINT_ONE_LINE)
+		out_newline(&out);
+	out_flush(&out);
+}
+
+/*
+ * All message buffers of a transfer are carved out of a single arena.
+ * It only ever grows, so repeated transfers (script mode) reuse the
+ * same memory without any further allocation.
+ */
+struct msg_arena {
+	__u8 *base;
+	size_t size;
+	size_t used;
+};
+
+/* Returns the offset of the new buffer, or -1 if out of memory */
+static long arena_alloc(struct msg_arena *arena, size_t len)
+{
+	size_t offset = arena->used;
+
+	if (arena->used + len > arena->size) {
+		size_t size = arena->size ? arena->size : 4096;
+		__u8 *base;
+
+		while (size < arena->used + len)
+			size *= 2;
+		base = realloc(arena->base, size);
+		if (!base)
+			return -1;
+		arena->base = base;
+		arena->size = size;
+	}
+
+	arena->used += len;
+	return offset;
+}
+
+/*
+ * Write the data of read messages to raw_out if set, unencoded, and
+ * print whatever print_flags still ask for.
+ */
+static int output_msgs(struct i2c_msg *msgs, __u32 nmsgs, unsigned flags,
+		       FILE *raw_out)
+{
+	__u32 i;
+
+	if (!raw_out) {
+		print_msgs(msgs, nmsgs, flags);
+		return 0;
+	}
+
+	if (flags & PRINT_HEADER)
+		print_msgs(msgs, nmsgs, flags & ~PRINT_READ_BUF);
+	for (i = 0; i < nmsgs; i++) {
+		if (!(msgs[i].flags & I2C_M_RD) || !msgs[i].len)
+			continue;
+		if (fwrite(msgs[i].buf, 1, msgs[i].len, raw_out) != msgs[i].len) {
+			fprintf(stderr, "Error: Could not write read data: "
+				"%s\n", strerror(errno));
+			return -1;
+		}
+	}
+
+	return 0;
 }
 
 static int confirm(const char *filename, struct i2c_msg *msgs, __u32 nmsgs)
@@ -120,65 +246,76 @@ static int confirm(const char *filename, struct i2c_msg *msgs, __u32 nmsgs)
 	return 1;
 }
 
-int main(int argc, char *argv[])
+static int confirm_script(const char *filename, const char *script)
 {
-	char filename[20];
-	char *end;
-	int i2cbus, address = -1, file, arg_idx = 1, nmsgs = 0, nmsgs_sent, i;
-	int force = 0, yes = 0, version = 0, verbose = 0;
-	unsigned buf_idx = 0;
-	unsigned long len, raw_data;
-	__u8 data;
-	__u8 *buf;
-	__u16 flags;
-	struct i2c_msg msgs[I2C_RDRW_IOCTL_MAX_MSGS];
-	struct i2c_rdwr_ioctl_data rdwr;
-	enum parse_state state = PARSE_GET_DESC;
-
-	for (i = 0; i < I2C_RDRW_IOCTL_MAX_MSGS; i++)
-		msgs[i].buf = NULL;
+	fprintf(stderr, "WARNING! This program can confuse your I2C bus, cause data loss and worse!\n");
+	fprintf(stderr, "I will send the messages described in %s to device file %s.\n",
+		strcmp(script, "-") ? script : "standard input", filename);
 
-	/* handle (optional) arg_idx first */
-	while (arg_idx < argc && argv[arg_idx][0] == '-') {
-		switch (argv[arg_idx][1]) {
-		case 'V': version = 1; break;
-		case 'v': verbose = 1; break;
-		case 'f': force = 1; break;
-		case 'y': yes = 1; break;
-		default:
-			fprintf(stderr, "Error: Unsupported option "
-				"\"%s\"!\n", argv[arg_idx]);
-			help();
-			exit(1);
-		}
-		arg_idx++;
+	fprintf(stderr, "Continue? [y/N] ");
+	fflush(stderr);
+	if (!user_ack(0)) {
+		fprintf(stderr, "Aborting on user request.\n");
+		return 0;
 	}
 
-	if (version) {
-		fprintf(stderr, "i2ctransfer version %s\n", VERSION);
-		exit(0);
+	return 1;
+}
+
+/* Fill buf with exactly len bytes read from a binary file */
+static int load_file(const char *path, __u8 *buf, size_t len)
+{
+	FILE *f;
+	size_t got;
+	int extra;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		fprintf(stderr, "Error: Could not open %s: %s\n", path,
+			strerror(errno));
+		return -1;
 	}
+	got = fread(buf, 1, len, f);
+	extra = fgetc(f) != EOF;
+	fclose(f);
 
-	if (arg_idx == argc) {
-		help();
-		exit(0);
+	if (got != len || extra) {
+		fprintf(stderr, "Error: %s doesn't hold the %zu remaining "
+			"bytes of the message\n", path, len);
+		return -1;
 	}
 
-	i2cbus = i2c_lookup_i2c_bus(argv[arg_idx++]);
-	if (i2cbus < 0)
-		exit(1);
+	return 0;
+}
 
-	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
-	if (file < 0 || check_funcs(file))
-		exit(1);
+/*
+ * Parse a DESC [DATA] [DESC [DATA]]... list into msgs. The last address
+ * used is kept in *address so that it can be reused by the next call.
+ * Message buffers point into the arena, which is reset first.
+ * Returns the number of messages, or -1 on error.
+ */
+static int parse_msgs(int file, int force, int nargs, char *args[],
+		      struct i2c_msg *msgs, struct msg_arena *arena,
+		      int *address)
+{
+	char *end;
+	int arg_idx, nmsgs = 0, i;
+	unsigned buf_idx = 0;
+	unsigned long len, raw_data;
+	long offsets[I2C_RDRW_IOCTL_MAX_MSGS];
+	__u8 data;
+	__u16 flags;
+	enum parse_state state = PARSE_GET_DESC;
 
-	while (arg_idx < argc) {
-		char *arg_ptr = argv[arg_idx];
+	arena->used = 0;
 
-		if (nmsgs > I2C_RDRW_IOCTL_MAX_MSGS) {
+	for (arg_idx = 0; arg_idx < nargs; arg_idx++) {
+		char *arg_ptr = args[arg_idx];
+
+		if (nmsgs >= I2C_RDRW_IOCTL_MAX_MSGS) {
 			fprintf(stderr, "Error: Too many messages (max: %d)\n",
 				I2C_RDRW_IOCTL_MAX_MSGS);
-			goto err_out;
+			return -1;
 		}
 
 		switch (state) {
@@ -211,33 +348,31 @@ int main(int argc, char *argv[])
 				 * here.
 				 */
 
-				address = i2c_parse_i2c_address(arg_ptr);
-				if (address < 0)
+				*address = i2c_parse_i2c_address(arg_ptr);
+				if (*address < 0)
 					goto err_out_with_arg;
 
-				if (!force && i2c_set_slave_addr(file, address, 0))
+				if (!force && i2c_set_slave_addr(file, *address, 0))
 					goto err_out_with_arg;
 
 			} else {
 				/* Reuse last address if possible */
-				if (address < 0) {
+				if (*address < 0) {
 					fprintf(stderr, "Error: No address given\n");
 					goto err_out_with_arg;
 				}
 			}
 
-			msgs[nmsgs].addr = address;
+			msgs[nmsgs].addr = *address;
 			msgs[nmsgs].flags = flags;
 			msgs[nmsgs].len = len;
 
-			if (len) {
-				buf = malloc(len);
-				if (!buf) {
-					fprintf(stderr, "Error: No memory for buffer\n");
-					goto err_out_with_arg;
-				}
-				memset(buf, 0, len);
-				msgs[nmsgs].buf = buf;
+			/* The arena may move while parsing, so only
+			   record offsets until we are done */
+			offsets[nmsgs] = arena_alloc(arena, len);
+			if (offsets[nmsgs] < 0) {
+				fprintf(stderr, "Error: No memory for buffer\n");
+				goto err_out_with_arg;
 			}
 
 			if ((flags & I2C_M_RD) || len == 0) {
@@ -249,6 +384,18 @@ int main(int argc, char *argv[])
 			break;
 
 		case PARSE_GET_DATA:
+			if (!strncmp(arg_ptr, "@file:", 6)) {
+				len = msgs[nmsgs].len;
+				if (load_file(arg_ptr + 6, arena->base +
+					      offsets[nmsgs] + buf_idx,
+					      len - buf_idx))
+					goto err_out_with_arg;
+				buf_idx = len;
+				nmsgs++;
+				state = PARSE_GET_DESC;
+				break;
+			}
+
 			raw_data = strtoul(arg_ptr, &end, 0);
 			if (raw_data > 255) {
 				fprintf(stderr, "Error: Data byte invalid\n");
@@ -258,7 +405,7 @@ int main(int argc, char *argv[])
 			len = msgs[nmsgs].len;
 
 			while (buf_idx < len) {
-				msgs[nmsgs].buf[buf_idx++] = data;
+				arena->base[offsets[nmsgs] + buf_idx++] = data;
 
 				if (!*end)
 					break;
@@ -284,43 +431,412 @@ int main(int argc, char *argv[])
 			fprintf(stderr, "Error: Unnkown state in state machine!\n");
 			goto err_out_with_arg;
 		}
-
-		arg_idx++;
 	}
 
 	if (state != PARSE_GET_DESC || nmsgs == 0) {
 		fprintf(stderr, "Error: Incomplete message\n");
-		goto err_out;
+		return -1;
 	}
 
-	if (!yes && !confirm(filename, msgs, nmsgs))
-		goto out;
+	for (i = 0; i < nmsgs; i++)
+		msgs[i].buf = msgs[i].len ? arena->base + offsets[i] : NULL;
+
+	return nmsgs;
+
+err_out_with_arg:
+	fprintf(stderr, "Error: faulty argument is '%s'\n", args[arg_idx]);
+	return -1;
+}
+
+static int do_transfer(int file, struct i2c_msg *msgs, int nmsgs)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+	int nmsgs_sent;
 
 	rdwr.msgs = msgs;
 	rdwr.nmsgs = nmsgs;
 	nmsgs_sent = ioctl(file, I2C_RDWR, &rdwr);
+	/* Refused by the adapter, split it to fit its limits */
+	if (nmsgs_sent < 0 && errno == EOPNOTSUPP) {
+		nmsgs_sent = i2c_transfer(file, msgs, nmsgs);
+		if (nmsgs_sent < 0)
+			errno = -nmsgs_sent;
+	}
 	if (nmsgs_sent < 0) {
 		fprintf(stderr, "Error: Sending messages failed: %s\n", strerror(errno));
-		goto err_out;
+		return -1;
 	} else if (nmsgs_sent < nmsgs) {
 		fprintf(stderr, "Warning: only %d/%d messages were sent\n", nmsgs_sent, nmsgs);
 	}
 
+	return nmsgs_sent;
+}
+
+static __u64 timespec_ns(const struct timespec *ts)
+{
+	return (__u64)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	__u64 x = *(const __u64 *)a, y = *(const __u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * Send the same transfer count times, optionally at a fixed period, and
+ * report statistics about the time spent in the ioctl. Only the ioctl is
+ * timed, so the numbers reflect the kernel and the bus, not this program.
+ * Returns the number of messages sent by the last transfer, or -1.
+ */
+static int run_repeat(int file, struct i2c_msg *msgs, int nmsgs,
+		      unsigned long count, __u64 interval_ns)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+	struct timespec start, end, next;
+	unsigned long i;
+	__u64 *lat, total = 0;
+	unsigned long bytes = 0;
+	int nmsgs_sent = -1, j;
+
+	lat = malloc(count * sizeof(*lat));
+	if (!lat) {
+		fprintf(stderr, "Error: No memory for statistics\n");
+		return -1;
+	}
+
+	for (j = 0; j < nmsgs; j++)
+		bytes += msgs[j].len;
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = nmsgs;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	for (i = 0; i < count; i++) {
+		if (i && interval_ns) {
+			__u64 ns = timespec_ns(&next) + interval_ns;
+
+			next.tv_sec = ns / 1000000000;
+			next.tv_nsec = ns % 1000000000;
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+					NULL);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		nmsgs_sent = ioctl(file, I2C_RDWR, &rdwr);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		if (nmsgs_sent < 0) {
+			fprintf(stderr, "Error: Sending messages failed on "
+				"iteration %lu: %s\n", i + 1, strerror(errno));
+			free(lat);
+			return -1;
+		} else if (nmsgs_sent < nmsgs) {
+			fprintf(stderr, "Warning: only %d/%d messages were "
+				"sent on iteration %lu\n", nmsgs_sent, nmsgs,
+				i + 1);
+		}
+
+		lat[i] = timespec_ns(&end) - timespec_ns(&start);
+		total += lat[i];
+	}
+
+	qsort(lat, count, sizeof(*lat), cmp_u64);
+	printf("%lu transfers, %lu bytes each\n", count, bytes);
+	printf("latency (us): min %.1f, mean %.1f, p99 %.1f, max %.1f\n",
+	       lat[0] / 1000.0, total / 1000.0 / count,
+	       lat[(count * 99 + 99) / 100 - 1] / 1000.0,
+	       lat[count - 1] / 1000.0);
+	printf("throughput: %.0f bytes/s\n",
+	       total ? (double)bytes * count * 1000000000 / total : 0.0);
+
+	free(lat);
+	return nmsgs_sent;
+}
+
+/* Split a script line into whitespace separated arguments, in place */
+static int split_line(char *line, char ***args, int *max_args)
+{
+	char *tok, *saveptr;
+	int nargs = 0;
+
+	for (tok = strtok_r(line, " \t\r\n", &saveptr); tok;
+	     tok = strtok_r(NULL, " \t\r\n", &saveptr)) {
+		if (*tok == '#')
+			break;
+		if (nargs == *max_args) {
+			int max = *max_args ? 2 * *max_args : 64;
+			char **new_args = realloc(*args, max * sizeof(char *));
+
+			if (!new_args) {
+				fprintf(stderr, "Error: No memory for arguments\n");
+				return -1;
+			}
+			*args = new_args;
+			*max_args = max;
+		}
+		(*args)[nargs++] = tok;
+	}
+
+	return nargs;
+}
+
+/*
+ * Execute one transfer per line of the script, all on the same open
+ * device file. Empty lines and comments (starting with #) are skipped.
+ */
+static int run_script(int file, int force, const char *script,
+		      struct i2c_msg *msgs, struct msg_arena *arena,
+		      unsigned print_flags, FILE *raw_out)
+{
+	FILE *f;
+	char *line = NULL, **args = NULL;
+	size_t size = 0;
+	int max_args = 0, nargs, nmsgs, nmsgs_sent;
+	int address = -1, line_nr = 0, ret = 0;
+
+	if (!strcmp(script, "-")) {
+		f = stdin;
+	} else {
+		f = fopen(script, "r");
+		if (!f) {
+			fprintf(stderr, "Error: Could not open script %s: %s\n",
+				script, strerror(errno));
+			return -1;
+		}
+	}
+
+	while (getline(&line, &size, f) > 0) {
+		line_nr++;
+
+		nargs = split_line(line, &args, &max_args);
+		if (nargs < 0) {
+			ret = -1;
+			break;
+		}
+		if (nargs == 0)
+			continue;
+
+		nmsgs = parse_msgs(file, force, nargs, args, msgs, arena,
+				   &address);
+		if (nmsgs < 0) {
+			fprintf(stderr, "Error: Invalid transfer on line %d\n",
+				line_nr);
+			ret = -1;
+			break;
+		}
+
+		nmsgs_sent = do_transfer(file, msgs, nmsgs);
+		if (nmsgs_sent < 0) {
+			fprintf(stderr, "Error: Transfer failed on line %d\n",
+				line_nr);
+			ret = -1;
+			break;
+		}
+		if (output_msgs(msgs, nmsgs_sent, print_flags, raw_out)) {
+			ret = -1;
+			break;
+		}
+	}
+
+	free(line);
+	free(args);
+	if (f != stdin)
+		fclose(f);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	char filename[20];
+	const char *script = NULL, *raw_path = NULL;
+	FILE *raw_out = NULL;
+	int i2cbus, address = -1, file, arg_idx = 1, nmsgs, nmsgs_sent;
+	int force = 0, yes = 0, version = 0, verbose = 0;
+	unsigned long count = 0;
+	double interval = 0;
+	char *end;
+	unsigned print_flags;
+	struct i2c_msg msgs[I2C_RDRW_IOCTL_MAX_MSGS];
+	struct msg_arena arena = { NULL, 0, 0 };
+
+	/* handle (optional) arg_idx first */
+	while (arg_idx < argc && argv[arg_idx][0] == '-') {
+		switch (argv[arg_idx][1]) {
+		case 'V': version = 1; break;
+		case 'v': verbose = 1; break;
+		case 'f': force = 1; break;
+		case 'y': yes = 1; break;
+		case 's':
+			if (arg_idx + 1 == argc) {
+				fprintf(stderr, "Error: No script given!\n");
+				help();
+				exit(1);
+			}
+			script = argv[++arg_idx];
+			break;
+		case 'o':
+			if (arg_idx + 1 == argc) {
+				fprintf(stderr, "Error: No output file given!\n");
+				help();
+				exit(1);
+			}
+			raw_path = argv[++arg_idx];
+			break;
+		case 'n':
+			if (arg_idx + 1 == argc) {
+				fprintf(stderr, "Error: No count given!\n");
+				help();
+				exit(1);
+			}
+			count = strtoul(argv[++arg_idx], &end, 0);
+			if (*end || count == 0) {
+				fprintf(stderr, "Error: Count invalid!\n");
+				help();
+				exit(1);
+			}
+			break;
+		case 'i':
+			if (arg_idx + 1 == argc) {
+				fprintf(stderr, "Error: No interval given!\n");
+				help();
+				exit(1);
+			}
+			interval = strtod(argv[++arg_idx], &end);
+			if (*end || interval < 0) {
+				fprintf(stderr, "Error: Interval invalid!\n");
+				help();
+				exit(1);
+			}
+			break;
+		default:
+			fprintf(stderr, "Error: Unsupported option "
+				"\"%s\"!\n", argv[arg_idx]);
+			help();
+			exit(1);
+		}
+		arg_idx++;
+	}
+
+	if (version) {
+		fprintf(stderr, "i2ctransfer version %s\n", VERSION);
+		exit(0);
+	}
+
+	if (arg_idx == argc) {
+		help();
+		exit(0);
+	}
+
+	if (interval && !count) {
+		fprintf(stderr, "Error: Interval requires a count!\n");
+		help();
+		exit(1);
+	}
+
+	if (script && count) {
+		fprintf(stderr, "Error: Count not supported with a script!\n");
+		help();
+		exit(1);
+	}
+
+	/* The confirmation would be read from the script itself */
+	if (script && !strcmp(script, "-") && !yes) {
+		fprintf(stderr, "Error: A script from standard input "
+			"requires -y!\n");
+		help();
+		exit(1);
+	}
+
+	if (script && arg_idx + 1 != argc) {
+		fprintf(stderr, "Error: No DESC allowed with a script!\n");
+		help();
+		exit(1);
+	}
+
+	i2cbus = i2c_lookup_i2c_bus(argv[arg_idx++]);
+	if (i2cbus < 0)
+		exit(1);
+
+	file = i2c_open_i2c_dev(i2cbus, filename, sizeof(filename), 0);
+	if (file < 0 || check_funcs(file))
+		exit(1);
+
+	print_flags = PRINT_READ_BUF | (verbose ? PRINT_HEADER | PRINT_WRITE_BUF : 0);
+
+	if (raw_path) {
+		if (!strcmp(raw_path, "-")) {
+			raw_out = stdout;
+			/* Keep the binary stream clean */
+			print_flags |= PRINT_STDERR;
+		} else {
+			raw_out = fopen(raw_path, "wb");
+			if (!raw_out) {
+				fprintf(stderr, "Error: Could not open %s: %s\n",
+					raw_path, strerror(errno));
+				goto err_out;
+			}
+		}
+	}
+
+	if (script) {
+		if (!yes && !confirm_script(filename, script))
+			goto out;
+		if (run_script(file, force, script, msgs, &arena, print_flags |
+			       (verbose || raw_out ? 0 : PRINT_ONE_LINE),
+			       raw_out))
+			goto err_out;
+		goto out;
+	}
+
+	nmsgs = parse_msgs(file, force, argc - arg_idx, argv + arg_idx, msgs,
+			   &arena, &address);
+	if (nmsgs < 0)
+		goto err_out;
+
+	if (!yes && !confirm(filename, msgs, nmsgs))
+		goto out;
+
+	if (count)
+		nmsgs_sent = run_repeat(file, msgs, nmsgs, count,
+					(__u64)(interval * 1000000));
+	else
+		nmsgs_sent = do_transfer(file, msgs, nmsgs);
+	if (nmsgs_sent < 0)
+		goto err_out;
+
 	close(file);
 
-	print_msgs(msgs, nmsgs_sent, PRINT_READ_BUF | (verbose ? PRINT_HEADER | PRINT_WRITE_BUF : 0));
+	if (output_msgs(msgs, nmsgs_sent, print_flags, raw_out))
+		goto err_out_closed;
+	if (raw_out && fclose(raw_out)) {
+		fprintf(stderr, "Error: Could not write read data: %s\n",
+			strerror(errno));
+		raw_out = NULL;
+		goto err_out_closed;
+	}
+	free(arena.base);
 
-out:
-	for (i = 0; i <= nmsgs; i++)
-		free(msgs[i].buf);
+	exit(0);
 
+out:
+	close(file);
+	if (raw_out && fclose(raw_out)) {
+		fprintf(stderr, "Error: Could not write read data: %s\n",
+			strerror(errno));
+		free(arena.base);
+		exit(1);
+	}
+	free(arena.base);
 	exit(0);
 
-err_out_with_arg:
-	fprintf(stderr, "Error: faulty argument is '%s'\n", argv[arg_idx]);
 err_out:
-	for (i = 0; i <= nmsgs; i++)
-		free(msgs[i].buf);
-
+	close(file);
+err_out_closed:
+	if (raw_out)
+		fclose(raw_out);
+	free(arena.base);
 	exit(1);
 }
@@ -0,0 +1,420 @@
+/*
+    regset - batched register writes with mask and readback
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/smbus.h>
+#include "i2cbusses.h"
+#include "regset.h"
+
+#define MAX_BATCH	(I2C_RDRW_IOCTL_MAX_MSGS / 2)
+
+static int parse_int(const char *s, char **end, long max)
+{
+	long value;
+
+	value = strtol(s, end, 0);
+	if (*end == s || value < 0 || value > max)
+		return -1;
+	return value;
+}
+
+int regset_parse_entry(const char *s, int size, struct regset_entry *entry)
+{
+	char *end;
+	int max;
+
+	entry->daddress = parse_int(s, &end, 0xff);
+	if (entry->daddress < 0 || *end != '=')
+		return -1;
+
+	/* The mode comes last, but the value range depends on it */
+	entry->size = size;
+	s = end + 1;
+	end = strchr(s, ':');
+	if (end) {
+		if (end[1] == 'b' && !end[2])
+			entry->size = I2C_SMBUS_BYTE_DATA;
+		else if (end[1] == 'w' && !end[2])
+			entry->size = I2C_SMBUS_WORD_DATA;
+		else
+			return -1;
+	}
+	max = entry->size == I2C_SMBUS_WORD_DATA ? 0xffff : 0xff;
+
+	entry->value = parse_int(s, &end, max);
+	if (entry->value < 0)
+		return -1;
+
+	entry->vmask = 0;
+	if (*end == '/') {
+		entry->vmask = parse_int(end + 1, &end, max);
+		if (entry->vmask <= 0)
+			return -1;
+	}
+	if (*end && *end != ':')
+		return -1;
+
+	entry->oldvalue = -1;
+	return 0;
+}
+
+int regset_check_funcs(unsigned long funcs, const struct regset_entry *entries,
+		       int n, int flags)
+{
+	int i, byte = 0, word = 0, masked = 0;
+
+	for (i = 0; i < n; i++) {
+		if (entries[i].size == I2C_SMBUS_WORD_DATA)
+			word = 1;
+		else
+			byte = 1;
+		if (entries[i].vmask)
+			masked = 1;
+	}
+
+	if (byte && !(funcs & I2C_FUNC_SMBUS_WRITE_BYTE_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus write byte");
+		return -1;
+	}
+	if (word && !(funcs & I2C_FUNC_SMBUS_WRITE_WORD_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus write word");
+		return -1;
+	}
+	if (masked && byte && !(funcs & I2C_FUNC_SMBUS_READ_BYTE_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus read byte");
+		return -1;
+	}
+	if (masked && word && !(funcs & I2C_FUNC_SMBUS_READ_WORD_DATA)) {
+		fprintf(stderr, MISSING_FUNC_FMT, "SMBus read word");
+		return -1;
+	}
+
+	if ((flags & REGSET_PEC)
+	 && !(funcs & (I2C_FUNC_SMBUS_PEC | I2C_FUNC_I2C))) {
+		fprintf(stderr, "Warning: Adapter does "
+			"not seem to support PEC\n");
+	}
+
+	return 0;
+}
+
+/* The kernel only computes PEC for SMBus transfers */
+static int use_rdwr(unsigned long funcs, int flags)
+{
+	return (funcs & I2C_FUNC_I2C) && !(flags & REGSET_PEC);
+}
+
+static int read_one(int file, const struct regset_entry *entry)
+{
+	int res;
+
+	switch (entry->size) {
+	case I2C_SMBUS_BYTE:
+		if (entry->daddress >= 0) {
+			res = i2c_smbus_write_byte(file, entry->daddress);
+			if (res < 0)
+				fprintf(stderr, "Warning - write failed\n");
+		}
+		return i2c_smbus_read_byte(file);
+	case I2C_SMBUS_WORD_DATA:
+		return i2c_smbus_read_word_data(file, entry->daddress);
+	default: /* I2C_SMBUS_BYTE_DATA */
+		return i2c_smbus_read_byte_data(file, entry->daddress);
+	}
+}
+
+/*
+ * Each register read is a data address write, repeated start, and read,
+ * which is exactly what the SMBus read byte/word data transactions are.
+ * Returns 0 or a negative errno value.
+ */
+static int read_batch(int file, int address,
+		      const struct regset_entry *entries, int n, int *values)
+{
+	struct i2c_msg msgs[2 * MAX_BATCH];
+	struct i2c_rdwr_ioctl_data rdwr;
+	__u8 cmd[MAX_BATCH], buf[MAX_BATCH][2];
+	int i, res;
+
+	for (i = 0; i < n; i++) {
+		cmd[i] = entries[i].daddress;
+		msgs[2 * i].addr = address;
+		msgs[2 * i].flags = 0;
+		msgs[2 * i].len = 1;
+		msgs[2 * i].buf = &cmd[i];
+		msgs[2 * i + 1].addr = address;
+		msgs[2 * i + 1].flags = I2C_M_RD;
+		msgs[2 * i + 1].len =
+			entries[i].size == I2C_SMBUS_WORD_DATA ? 2 : 1;
+		msgs[2 * i + 1].buf = buf[i];
+	}
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = 2 * n;
+	res = ioctl(file, I2C_RDWR, &rdwr);
+	if (res < 0)
+		return -errno;
+	if (res != 2 * n)
+		return -EIO;
+
+	for (i = 0; i < n; i++)
+		values[i] = entries[i].size == I2C_SMBUS_WORD_DATA ?
+			    buf[i][0] | buf[i][1] << 8 : buf[i][0];
+	return 0;
+}
+
+int regset_read(int file, int address, unsigned long funcs, int flags,
+		const struct regset_entry *entries, int n, int *values)
+{
+	int i = 0, batch, res, rdwr = use_rdwr(funcs, flags);
+
+	while (i < n) {
+		batch = 0;
+		if (rdwr)
+			while (i + batch < n && batch < MAX_BATCH
+			    && entries[i + batch].size != I2C_SMBUS_BYTE)
+				batch++;
+		if (batch > 1) {
+			res = read_batch(file, address, entries + i, batch,
+					 values + i);
+			if (!res) {
+				i += batch;
+				continue;
+			}
+			/*
+			 * Reads may have side effects, so registers are only
+			 * read again one by one if the adapter refused the
+			 * transfer before it reached the bus.
+			 */
+			if (res != -EOPNOTSUPP && res != -EINVAL)
+				return i;
+			rdwr = 0;
+		}
+
+		values[i] = read_one(file, &entries[i]);
+		if (values[i] < 0)
+			return i;
+		i++;
+	}
+
+	return n;
+}
+
+/*
+ * Number of entries, starting with entries[0], which can be written in
+ * a single transfer: with REGSET_AUTOINC, that is a run of byte
+ * registers at consecutive data addresses.
+ */
+static int run_length(const struct regset_entry *entries, int n, int flags)
+{
+	int len = 1;
+
+	if (!(flags & REGSET_AUTOINC)
+	 || entries[0].size != I2C_SMBUS_BYTE_DATA)
+		return 1;
+
+	while (len < n && len < I2C_SMBUS_BLOCK_MAX
+	    && entries[len].size == I2C_SMBUS_BYTE_DATA
+	    && entries[len].daddress == entries[0].daddress + len)
+		len++;
+	return len;
+}
+
+/*
+ * Write runs of registers with I2C_RDWR, one message per run. Messages
+ * are only combined in a transfer, with repeated starts between them,
+ * with REGSET_BATCH; otherwise each write ends with a stop. Returns the
+ * number of entries written, or -1 if the transfer failed, in which
+ * case it isn't known which messages made it.
+ */
+static int write_batch(int file, int address,
+		       const struct regset_entry *entries, int n, int flags)
+{
+	struct i2c_msg msgs[I2C_RDRW_IOCTL_MAX_MSGS];
+	struct i2c_rdwr_ioctl_data rdwr;
+	__u8 buf[I2C_RDRW_IOCTL_MAX_MSGS][I2C_SMBUS_BLOCK_MAX + 1];
+	int i = 0, j, len, nmsgs = 0, max_msgs;
+
+	max_msgs = flags & REGSET_BATCH ? I2C_RDRW_IOCTL_MAX_MSGS : 1;
+	while (i < n && nmsgs < max_msgs) {
+		len = run_length(entries + i, n - i, flags);
+
+		buf[nmsgs][0] = entries[i].daddress;
+		msgs[nmsgs].addr = address;
+		msgs[nmsgs].flags = 0;
+		msgs[nmsgs].buf = buf[nmsgs];
+		if (entries[i].size == I2C_SMBUS_WORD_DATA) {
+			buf[nmsgs][1] = entries[i].value & 0xff;
+			buf[nmsgs][2] = entries[i].value >> 8;
+			msgs[nmsgs].len = 3;
+		} else {
+			for (j = 0; j < len; j++)
+				buf[nmsgs][1 + j] = entries[i + j].value;
+			msgs[nmsgs].len = 1 + len;
+		}
+
+		nmsgs++;
+		i += len;
+	}
+
+	rdwr.msgs = msgs;
+	rdwr.nmsgs = nmsgs;
+	if (ioctl(file, I2C_RDWR, &rdwr) != nmsgs)
+		return -1;
+
+	return i;
+}
+
+static int write_one(int file, const struct regset_entry *entries, int len)
+{
+	__u8 block[I2C_SMBUS_BLOCK_MAX];
+	int i;
+
+	if (entries[0].size == I2C_SMBUS_WORD_DATA)
+		return i2c_smbus_write_word_data(file, entries[0].daddress,
+						 entries[0].value);
+	if (len == 1)
+		return i2c_smbus_write_byte_data(file, entries[0].daddress,
+						 entries[0].value);
+
+	for (i = 0; i < len; i++)
+		block[i] = entries[i].value;
+	return i2c_smbus_write_i2c_block_data(file, entries[0].daddress, len,
+					      block);
+}
+
+int regset_write(int file, int address, unsigned long funcs, int flags,
+		 const struct regset_entry *entries, int n)
+{
+	int i = 0, len;
+
+	/* I2C block writes can't do PEC */
+	if (!use_rdwr(funcs, flags)
+	 && ((flags & REGSET_PEC)
+	  || !(funcs & I2C_FUNC_SMBUS_WRITE_I2C_BLOCK)))
+		flags &= ~REGSET_AUTOINC;
+
+	while (i < n) {
+		if (use_rdwr(funcs, flags)) {
+			len = write_batch(file, address, entries + i, n - i,
+					  flags);
+		} else {
+			len = run_length(entries + i, n - i, flags);
+			if (write_one(file, entries + i, len) < 0)
+				len = -1;
+		}
+		if (len < 0)
+			return i;
+		i += len;
+	}
+
+	return n;
+}
+
+int regset_fetch(int file, int address, unsigned long funcs, int flags,
+		 struct regset_entry *entries, int n, int all)
+{
+	struct regset_entry *todo;
+	int *map, *values;
+	int i, count = 0, res;
+
+	todo = malloc(n * sizeof(*todo));
+	map = malloc(n * sizeof(*map));
+	values = malloc(n * sizeof(*values));
+	if (!todo || !map || !values) {
+		res = 0;
+		goto out;
+	}
+
+	/* Read only what we need, but in a single pass */
+	for (i = 0; i < n; i++) {
+		if (!all && !entries[i].vmask)
+			continue;
+		todo[count] = entries[i];
+		map[count++] = i;
+	}
+
+	if (!count) {
+		res = n;
+		goto out;
+	}
+
+	res = regset_read(file, address, funcs, flags, todo, count, values);
+	if (res < count) {
+		res = map[res];
+		goto out;
+	}
+
+	for (i = 0; i < count; i++) {
+		struct regset_entry *entry = &entries[map[i]];
+
+		entry->oldvalue = values[i];
+		if (entry->vmask)
+			entry->value = (entry->value & entry->vmask)
+				     | (entry->oldvalue & ~entry->vmask);
+	}
+	res = n;
+
+out:
+	free(values);
+	free(map);
+	free(todo);
+	return res;
+}
+
+int regset_verify(int file, int address, unsigned long funcs, int flags,
+		  const struct regset_entry *entries, int n)
+{
+	int *values;
+	int i, res, bad = 0;
+
+	values = malloc(n * sizeof(*values));
+	if (!values) {
+		printf("Warning - readback failed\n");
+		return n;
+	}
+
+	res = regset_read(file, address, funcs, flags, entries, n, values);
+	for (i = 0; i < res; i++) {
+		int width = entries[i].size == I2C_SMBUS_WORD_DATA ? 4 : 2;
+
+		if (values[i] != entries[i].value) {
+			printf("Warning - data mismatch at 0x%02x - wrote "
+			       "0x%0*x, read back 0x%0*x\n",
+			       entries[i].daddress, width, entries[i].value,
+			       width, values[i]);
+			bad++;
+		}
+	}
+	if (res < n) {
+		printf("Warning - readback failed at 0x%02x\n",
+		       entries[res].daddress);
+		bad += n - res;
+	}
+
+	free(values);
+	return bad;
+}
@@ -0,0 +1,75 @@
+/*
+    regset - batched register writes with mask and readback
+    Copyright (C) 2014 Danielle Costantino <danielle.costantino@gmail.com>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+    MA 02110-1301 USA.
+*/
+
+#ifndef _REGSET_H
+#define _REGSET_H
+
+/* One register to write, or to read */
+struct regset_entry {
+	int daddress;		/* -1 to read the current one (byte only) */
+	int size;		/* I2C_SMBUS_BYTE_DATA or I2C_SMBUS_WORD_DATA,
+				   or I2C_SMBUS_BYTE for reads */
+	int value;
+	int vmask;		/* bits of value to write, 0 for all */
+	int oldvalue;		/* as read from the chip, -1 if not read */
+};
+
+/* Transfer options */
+#define REGSET_PEC	0x01	/* SMBus transactions with PEC only */
+#define REGSET_AUTOINC	0x02	/* chip auto-increments the data address */
+#define REGSET_BATCH	0x04	/* chip takes writes without a stop between */
+
+/* Parse "DATA-ADDRESS=VALUE[/MASK][:MODE]", returns 0 or -1 */
+extern int regset_parse_entry(const char *s, int size,
+			      struct regset_entry *entry);
+extern int regset_check_funcs(unsigned long funcs,
+			      const struct regset_entry *entries, int n,
+			      int flags);
+
+/*
+ * All transfer functions return the index of the first entry which
+ * failed, or n on success. Reads of byte and word data registers are
+ * batched into I2C_RDWR transfers when the adapter allows it; when such
+ * a transfer fails, the index of its first entry is returned, as it
+ * isn't known which registers were read. Writes are only batched with
+ * REGSET_BATCH, as some chips only commit a write on a stop condition.
+ */
+extern int regset_read(int file, int address, unsigned long funcs, int flags,
+		       const struct regset_entry *entries, int n, int *values);
+extern int regset_write(int file, int address, unsigned long funcs,
+			int flags, const struct regset_entry *entries, int n);
+
+/*
+ * Read the current value of masked entries (or all entries if all is
+ * set) into oldvalue, then merge the unmasked bits of oldvalue into
+ * value. Returns the index of the first entry which could not be read,
+ * or n on success.
+ */
+extern int regset_fetch(int file, int address, unsigned long funcs, int flags,
+			struct regset_entry *entries, int n, int all);
+
+/*
+ * Read back all entries and compare with the values written, warning
+ * about each difference. Returns the number of entries which failed.
+ */
+extern int regset_verify(int file, int address, unsigned long funcs,
+			 int flags, const struct regset_entry *entries, int n);
+
+#endif /* _REGSET_H */